@@ -3,6 +3,8 @@
 #include <time.h>
 #include <string.h>
 
+#include "fila.h"
+
 #define TAMANHO_FILA 5
 #define TAMANHO_PILHA 3
 
@@ -12,13 +14,11 @@ typedef struct {
     int id;         // identificador único
 } Peca;
 
-// Estrutura para a fila circular
-typedef struct {
-    Peca pecas[TAMANHO_FILA];
-    int frente;
-    int tras;
-    int quantidade;
-} FilaCircular;
+// Peça devolvida quando se tenta remover de uma fila vazia
+#define PECA_VAZIA ((Peca) {'?', -1})
+
+// Estrutura para a fila circular (ver fila.h)
+FILA_DEFINIR(FilaCircular, Peca, TAMANHO_FILA, , PECA_VAZIA)
 
 // Estrutura para a pilha de reserva
 typedef struct {
@@ -43,15 +43,11 @@ Peca gerarPeca() {
 
 // Função para inicializar a fila circular
 void inicializarFila(FilaCircular *fila) {
-    fila->frente = 0;
-    fila->tras = -1;
-    fila->quantidade = 0;
+    inicializarFilaVazia(fila);
     
     // Preenche a fila com peças iniciais
     for (int i = 0; i < TAMANHO_FILA; i++) {
-        fila->pecas[i] = gerarPeca();
-        fila->tras = (fila->tras + 1) % TAMANHO_FILA;
-        fila->quantidade++;
+        enfileirar(fila, gerarPeca());
     }
 }
 
@@ -61,16 +57,6 @@ void inicializarPilha(PilhaReserva *pilha) {
     pilha->quantidade = 0;
 }
 
-// Função para verificar se a fila está vazia
-int filaVazia(FilaCircular *fila) {
-    return fila->quantidade == 0;
-}
-
-// Função para verificar se a fila está cheia
-int filaCheia(FilaCircular *fila) {
-    return fila->quantidade == TAMANHO_FILA;
-}
-
 // Função para verificar se a pilha está vazia
 int pilhaVazia(PilhaReserva *pilha) {
     return pilha->quantidade == 0;
@@ -81,34 +67,6 @@ int pilhaCheia(PilhaReserva *pilha) {
     return pilha->quantidade == TAMANHO_PILHA;
 }
 
-// Função para enfileirar (inserir) uma peça na fila
-void enfileirar(FilaCircular *fila, Peca peca) {
-    if (filaCheia(fila)) {
-        printf("Erro: Fila cheia!\n");
-        return;
-    }
-    
-    fila->tras = (fila->tras + 1) % TAMANHO_FILA;
-    fila->pecas[fila->tras] = peca;
-    fila->quantidade++;
-}
-
-// Função para desenfileirar (remover) uma peça da fila
-Peca desenfileirar(FilaCircular *fila) {
-    Peca pecaVazia = {'?', -1}; // Peça vazia para erro
-    
-    if (filaVazia(fila)) {
-        printf("Erro: Fila vazia!\n");
-        return pecaVazia;
-    }
-    
-    Peca pecaRemovida = fila->pecas[fila->frente];
-    fila->frente = (fila->frente + 1) % TAMANHO_FILA;
-    fila->quantidade--;
-    
-    return pecaRemovida;
-}
-
 // Função para empilhar (reservar) uma peça
 void empilhar(PilhaReserva *pilha, Peca peca) {
     if (pilhaCheia(pilha)) {
@@ -146,14 +104,12 @@ void visualizarFila(FilaCircular *fila) {
         return;
     }
     
-    int indice = fila->frente;
-    
     for (int i = 0; i < fila->quantidade; i++) {
+        Peca *peca = posicaoFila(fila, i);
         printf("Posição %d: Peça '%c' (ID: %d)\n", 
                i + 1, 
-               fila->pecas[indice].tipo, 
-               fila->pecas[indice].id);
-        indice = (indice + 1) % TAMANHO_FILA;
+               peca->tipo, 
+               peca->id);
     }
     
     printf("Total de peças na fila: %d\n", fila->quantidade);
@@ -0,0 +1,693 @@
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "estatisticas.h"
+#include "filapecas.h"
+#include "motor.h"
+#include "relogio.h"
+#include "salvamento.h"
+
+// Micro-benchmarks das estruturas do Tetris - Nível Mestre
+// Mede cada primitiva da fila, da pilha e do histórico em várias capacidades:
+// aquece e calibra o número de iterações, repete a medição, resume as
+// repetições (mínimo, mediana, média, desvio, máximo) e, quando o kernel
+// permite, conta ciclos com os contadores de desempenho (perf_event).
+//
+// Uso:
+//   TETRIS_BENCHMARK [--repeticoes N] [--tempo-min MS] [--filtro TEXTO] [--json ARQUIVO|-]
+
+#define REPETICOES_PADRAO 15
+#define TEMPO_MINIMO_PADRAO_MS 20.0
+#define MAX_REPETICOES 1000
+
+// Fila com capacidade escolhida em tempo de execução, para variar a capacidade
+FILA_DINAMICA_DEFINIR(FilaBenchmark, Peca, Benchmark, PECA_VAZIA)
+
+// Estruturas usadas pelos casos
+typedef struct {
+    int capacidade;
+    FilaCircular fila;
+    PilhaReserva pilha;
+    FilaCircular filaInicial;       // estado restaurado a cada iteração nos casos com cópia
+    PilhaReserva pilhaInicial;
+    FilaBenchmark filaDinamica;
+    FilaPecas filaPecas;
+    FilaProdutor filaSpsc;
+    unsigned char *tipos;
+    HistoricoJogo historico;
+    Arena arena;
+    PoolBlocos pool;
+    void **blocos;
+    EstadoJogo estado;
+    ImagemJogo *imagem;
+    char caminhoSalvamento[32];
+} Contexto;
+
+typedef struct {
+    const char *nome;
+    int capacidade;
+    int (*preparar)(Contexto *contexto);
+    void (*executar)(Contexto *contexto, long iteracoes);
+    void (*liberar)(Contexto *contexto);
+    int operacoesPorIteracao;
+    const char *observacao;
+} CasoBenchmark;
+
+// Impede o compilador de descartar o trabalho feito sobre "p"
+static inline void naoOtimizar(void *p) {
+    __asm__ volatile("" : : "g"(p) : "memory");
+}
+
+// Contador de ciclos do processador (só do espaço de usuário)
+// Retorna -1 quando o kernel ou o contêiner não permite.
+static int abrirContadorCiclos(void) {
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.type = PERF_TYPE_HARDWARE;
+    atributos.size = sizeof(atributos);
+    atributos.config = PERF_COUNT_HW_CPU_CYCLES;
+    atributos.disabled = 1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+}
+
+static long long lerContador(int contador) {
+    long long valor = 0;
+    if (contador < 0 || read(contador, &valor, sizeof(valor)) != sizeof(valor)) return -1;
+    return valor;
+}
+
+// Preenche fila e pilha até a capacidade, com ids sequenciais
+static void encherFilaPilha(FilaCircular *fila, PilhaReserva *pilha) {
+    inicializarFilaVazia(fila);
+    inicializarPilha(pilha);
+    for (int i = 0; i < TAMANHO_FILA; i++) {
+        enfileirar(fila, (Peca) {(unsigned char) (i % TOTAL_TIPOS_PECA), i});
+    }
+    for (int i = 0; i < TAMANHO_PILHA; i++) {
+        empilhar(pilha, (Peca) {(unsigned char) (i % TOTAL_TIPOS_PECA), TAMANHO_FILA + i});
+    }
+}
+
+// Casos da fila
+static int prepararFila(Contexto *contexto) {
+    inicializarFilaVazia(&contexto->fila);
+    return 1;
+}
+
+static void executarFila(Contexto *contexto, long iteracoes) {
+    FilaCircular *fila = &contexto->fila;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < TAMANHO_FILA; k++) enfileirar(fila, peca);
+        for (int k = 0; k < TAMANHO_FILA; k++) peca = desenfileirar(fila);
+        naoOtimizar(fila);
+    }
+}
+
+static int prepararFilaDinamica(Contexto *contexto) {
+    return criarFilaBenchmark(&contexto->filaDinamica, contexto->capacidade);
+}
+
+static void executarFilaDinamica(Contexto *contexto, long iteracoes) {
+    FilaBenchmark *fila = &contexto->filaDinamica;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) enfileirarBenchmark(fila, peca);
+        for (int k = 0; k < contexto->capacidade; k++) peca = desenfileirarBenchmark(fila);
+        naoOtimizar(fila);
+    }
+}
+
+static void liberarFilaDinamica(Contexto *contexto) {
+    liberarFilaBenchmark(&contexto->filaDinamica);
+}
+
+static int prepararFilaPecas(Contexto *contexto) {
+    return criarFilaPecas(&contexto->filaPecas, contexto->capacidade);
+}
+
+static void executarFilaPecas(Contexto *contexto, long iteracoes) {
+    FilaPecas *fila = &contexto->filaPecas;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) enfileirarPecas(fila, peca);
+        for (int k = 0; k < contexto->capacidade; k++) peca = desenfileirarPecas(fila);
+        naoOtimizar(fila);
+    }
+}
+
+static void liberarFilaPecasContexto(Contexto *contexto) {
+    liberarFilaPecas(&contexto->filaPecas);
+}
+
+// Fila SPSC do produtor de peças, numa só thread: mede o custo das operações
+// atômicas sem disputa (o caso comum do jogo com o gerador assíncrono)
+static int prepararFilaSpsc(Contexto *contexto) {
+    inicializarFilaSpscProdutor(&contexto->filaSpsc);
+    return 1;
+}
+
+static void executarFilaSpsc(Contexto *contexto, long iteracoes) {
+    FilaProdutor *fila = &contexto->filaSpsc;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) enfileirarSpscProdutor(fila, peca);
+        for (int k = 0; k < contexto->capacidade; k++) desenfileirarSpscProdutor(fila, &peca);
+        naoOtimizar(fila);
+    }
+}
+
+// Varredura dos tipos de uma fila cheia, nas duas disposições: vetor de peças
+// (4 bytes por peça) e vetor só de tipos (1 byte por peça)
+static int prepararVarreduraFilas(Contexto *contexto) {
+    GeradorPecas gerador;
+    inicializarGerador(&gerador, 1, GERADOR_SACO);
+    if (!criarFilaBenchmark(&contexto->filaDinamica, contexto->capacidade)) return 0;
+    if (!criarFilaPecas(&contexto->filaPecas, contexto->capacidade)) {
+        liberarFilaBenchmark(&contexto->filaDinamica);
+        return 0;
+    }
+
+    for (int k = 0; k < contexto->capacidade; k++) {
+        Peca peca = proximaPeca(&gerador);
+        enfileirarBenchmark(&contexto->filaDinamica, peca);
+        enfileirarPecas(&contexto->filaPecas, peca);
+    }
+    return 1;
+}
+
+static void executarVarreduraFilaDinamica(Contexto *contexto, long iteracoes) {
+    FilaBenchmark *fila = &contexto->filaDinamica;
+    for (long i = 0; i < iteracoes; i++) {
+        long pecasI = 0;
+        for (int k = 0; k < fila->quantidade; k++) pecasI += posicaoFilaBenchmark(fila, k)->tipo == PECA_I;
+        naoOtimizar(&pecasI);
+    }
+}
+
+static void executarVarreduraFilaPecas(Contexto *contexto, long iteracoes) {
+    const unsigned char *trechos[2];
+    size_t tamanhos[2];
+    trechosTiposFilaPecas(&contexto->filaPecas, &trechos[0], &tamanhos[0], &trechos[1], &tamanhos[1]);
+
+    for (long i = 0; i < iteracoes; i++) {
+        long pecasI = 0;
+        for (int t = 0; t < 2; t++) {
+            for (size_t k = 0; k < tamanhos[t]; k++) pecasI += trechos[t][k] == PECA_I;
+        }
+        naoOtimizar(&pecasI);
+    }
+}
+
+static void liberarVarreduraFilas(Contexto *contexto) {
+    liberarFilaBenchmark(&contexto->filaDinamica);
+    liberarFilaPecas(&contexto->filaPecas);
+}
+
+// Casos das estatísticas: a mesma sequência de tipos em cada nível SIMD (o
+// caso é ignorado se a CPU não suportar o nível)
+static int prepararEstatisticas(Contexto *contexto, NivelSimd nivel) {
+    if (!definirNivelSimdEstatisticas(nivel)) return 0;
+    contexto->tipos = malloc((size_t) contexto->capacidade);
+    if (contexto->tipos == NULL) return 0;
+
+    GeradorPecas gerador;
+    inicializarGerador(&gerador, 1, GERADOR_SACO);
+    gerarLoteTipos(&gerador, contexto->tipos, (size_t) contexto->capacidade);
+    return 1;
+}
+
+static int prepararEstatisticasEscalar(Contexto *contexto) {
+    return prepararEstatisticas(contexto, SIMD_ESCALAR);
+}
+
+static int prepararEstatisticasSsse3(Contexto *contexto) {
+    return prepararEstatisticas(contexto, SIMD_SSSE3);
+}
+
+static int prepararEstatisticasAvx2(Contexto *contexto) {
+    return prepararEstatisticas(contexto, SIMD_AVX2);
+}
+
+static void executarEstatisticas(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        EstatisticasPecas estatisticas;
+        inicializarEstatisticasPecas(&estatisticas);
+        acumularTipos(&estatisticas, contexto->tipos, (size_t) contexto->capacidade);
+        naoOtimizar(&estatisticas);
+    }
+}
+
+static void liberarEstatisticas(Contexto *contexto) {
+    free(contexto->tipos);
+    contexto->tipos = NULL;
+}
+
+// Casos dos alocadores: "capacidade" estados de jogo de rascunho por
+// iteração, pedidos à arena (e descartados de uma vez), ao pool ou ao malloc
+static int prepararArena(Contexto *contexto) {
+    size_t bytes = (size_t) contexto->capacidade * (sizeof(EstadoJogo) + sizeof(int) + 64) + 64;
+    contexto->blocos = malloc((size_t) contexto->capacidade * sizeof(void *));
+    if (contexto->blocos == NULL) return 0;
+    if (!criarArena(&contexto->arena, bytes)) {
+        free(contexto->blocos);
+        return 0;
+    }
+    return 1;
+}
+
+static void executarArena(Contexto *contexto, long iteracoes) {
+    Arena *arena = &contexto->arena;
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) {
+            naoOtimizar(alocarArena(arena, sizeof(EstadoJogo), _Alignof(EstadoJogo)));
+        }
+        reiniciarArena(arena);
+    }
+}
+
+static int prepararPool(Contexto *contexto) {
+    return prepararArena(contexto) &&
+           criarPoolArena(&contexto->pool, &contexto->arena, sizeof(EstadoJogo), 64, contexto->capacidade);
+}
+
+static void executarPool(Contexto *contexto, long iteracoes) {
+    PoolBlocos *pool = &contexto->pool;
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) contexto->blocos[k] = alocarPool(pool);
+        naoOtimizar(contexto->blocos);
+        for (int k = 0; k < contexto->capacidade; k++) devolverPool(pool, contexto->blocos[k]);
+    }
+}
+
+static void executarMalloc(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < contexto->capacidade; k++) contexto->blocos[k] = malloc(sizeof(EstadoJogo));
+        naoOtimizar(contexto->blocos);
+        for (int k = 0; k < contexto->capacidade; k++) free(contexto->blocos[k]);
+    }
+}
+
+static void liberarArenaContexto(Contexto *contexto) {
+    liberarArena(&contexto->arena);
+    free(contexto->blocos);
+    contexto->blocos = NULL;
+}
+
+// Casos do salvamento: uma partida com o histórico cheio, copiada para a
+// imagem (o que o jogo faz a cada entrega) ou retomada de um arquivo
+static int prepararSalvamento(Contexto *contexto) {
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
+    configuracao.capacidadeHistorico = (size_t) contexto->capacidade;
+    if (!inicializarJogo(&contexto->estado, &configuracao)) return 0;
+    for (int i = 0; i < 2 * contexto->capacidade; i++) {
+        executarAcao(&contexto->estado, i % 3 == 0 ? ACAO_MOVER_DIREITA : ACAO_JOGAR);
+    }
+
+    contexto->imagem = malloc(tamanhoImagem((size_t) contexto->capacidade));
+    snprintf(contexto->caminhoSalvamento, sizeof(contexto->caminhoSalvamento), "/tmp/benchmark-%d.ttrs", (int) getpid());
+    if (contexto->imagem == NULL || !salvarJogo(&contexto->estado, contexto->caminhoSalvamento)) {
+        free(contexto->imagem);
+        liberarJogo(&contexto->estado);
+        return 0;
+    }
+    return 1;
+}
+
+static void executarCapturaSalvamento(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        capturarImagem(contexto->imagem, &contexto->estado, (uint64_t) i);
+        naoOtimizar(contexto->imagem);
+    }
+}
+
+static void executarCargaSalvamento(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        carregarJogo(&contexto->estado, contexto->caminhoSalvamento);
+        naoOtimizar(&contexto->estado);
+    }
+}
+
+static void liberarSalvamento(Contexto *contexto) {
+    unlink(contexto->caminhoSalvamento);
+    free(contexto->imagem);
+    contexto->imagem = NULL;
+    liberarJogo(&contexto->estado);
+}
+
+// Casos da pilha
+static int prepararPilha(Contexto *contexto) {
+    inicializarPilha(&contexto->pilha);
+    return 1;
+}
+
+static void executarPilha(Contexto *contexto, long iteracoes) {
+    PilhaReserva *pilha = &contexto->pilha;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        for (int k = 0; k < TAMANHO_PILHA; k++) empilhar(pilha, peca);
+        for (int k = 0; k < TAMANHO_PILHA; k++) peca = desempilhar(pilha);
+        naoOtimizar(pilha);
+    }
+}
+
+// Casos do histórico
+static int prepararHistorico(Contexto *contexto) {
+    return inicializarHistorico(&contexto->historico, (size_t) contexto->capacidade);
+}
+
+static void executarAdicionarHistorico(Contexto *contexto, long iteracoes) {
+    HistoricoJogo *historico = &contexto->historico;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        peca.id = (int) i;
+        adicionarHistorico(historico, ACAO_JOGAR, peca, peca);
+        naoOtimizar(historico);
+    }
+}
+
+static void executarAdicionarRemoverHistorico(Contexto *contexto, long iteracoes) {
+    HistoricoJogo *historico = &contexto->historico;
+    Peca peca = {PECA_T, 0};
+    for (long i = 0; i < iteracoes; i++) {
+        peca.id = (int) i;
+        adicionarHistorico(historico, ACAO_JOGAR, peca, peca);
+        RegistroHistorico registro = removerHistorico(historico);
+        naoOtimizar(&registro);
+    }
+}
+
+static void liberarHistoricoContexto(Contexto *contexto) {
+    liberarHistorico(&contexto->historico);
+}
+
+// Casos das operações avançadas (fila e pilha cheias; todas são a própria
+// inversa, então o estado só alterna entre dois valores)
+static int prepararFilaPilha(Contexto *contexto) {
+    encherFilaPilha(&contexto->fila, &contexto->pilha);
+    contexto->filaInicial = contexto->fila;
+    contexto->pilhaInicial = contexto->pilha;
+    return 1;
+}
+
+static void executarTroca(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        trocarPecaFilaPilha(&contexto->fila, &contexto->pilha);
+        naoOtimizar(contexto);
+    }
+}
+
+static void executarTrocaBloco(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        trocarPecasFilaPilha(&contexto->fila, &contexto->pilha, TAMANHO_PILHA);
+        naoOtimizar(contexto);
+    }
+}
+
+static void executarInversao(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        inverterFilaComPilha(&contexto->fila, &contexto->pilha);
+        naoOtimizar(contexto);
+    }
+}
+
+// Inversão original do jogo: quatro laços de transferência por estruturas
+// temporárias. Ela perde peças quando a fila tem mais peças do que cabem na
+// pilha, por isso o estado é restaurado antes de cada chamada.
+static void inverterLegado(FilaCircular *fila, PilhaReserva *pilha) {
+    PilhaReserva tempPilha;
+    FilaCircular tempFila;
+    inicializarPilha(&tempPilha);
+    inicializarFilaVazia(&tempFila);
+
+    while (!filaVazia(fila)) empilhar(&tempPilha, desenfileirar(fila));
+    while (!pilhaVazia(pilha)) enfileirar(&tempFila, desempilhar(pilha));
+    while (!pilhaVazia(&tempPilha)) empilhar(pilha, desempilhar(&tempPilha));
+    while (!filaVazia(&tempFila)) enfileirar(fila, desenfileirar(&tempFila));
+}
+
+static void executarInversaoLegadaComCopia(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        contexto->fila = contexto->filaInicial;
+        contexto->pilha = contexto->pilhaInicial;
+        inverterLegado(&contexto->fila, &contexto->pilha);
+        naoOtimizar(contexto);
+    }
+}
+
+static void executarInversaoComCopia(Contexto *contexto, long iteracoes) {
+    for (long i = 0; i < iteracoes; i++) {
+        contexto->fila = contexto->filaInicial;
+        contexto->pilha = contexto->pilhaInicial;
+        inverterFilaComPilha(&contexto->fila, &contexto->pilha);
+        naoOtimizar(contexto);
+    }
+}
+
+static const CasoBenchmark CASOS[] = {
+    {"fila.enfileirar+desenfileirar", TAMANHO_FILA, prepararFila, executarFila, NULL, 2 * TAMANHO_FILA,
+     "FilaCircular do jogo: enche e esvazia"},
+    {"fila_dinamica.enfileirar+desenfileirar", 64, prepararFilaDinamica, executarFilaDinamica, liberarFilaDinamica, 2 * 64,
+     "enche e esvazia"},
+    {"fila_dinamica.enfileirar+desenfileirar", 1024, prepararFilaDinamica, executarFilaDinamica, liberarFilaDinamica, 2 * 1024,
+     "enche e esvazia"},
+    {"fila_dinamica.enfileirar+desenfileirar", 65536, prepararFilaDinamica, executarFilaDinamica, liberarFilaDinamica, 2 * 65536,
+     "enche e esvazia"},
+    {"fila_pecas.enfileirar+desenfileirar", 65536, prepararFilaPecas, executarFilaPecas, liberarFilaPecasContexto,
+     2 * 65536, "tipos e ids em vetores separados (SoA)"},
+    {"fila_spsc.enfileirar+desenfileirar", CAPACIDADE_PRODUTOR, prepararFilaSpsc, executarFilaSpsc, NULL,
+     2 * CAPACIDADE_PRODUTOR, "fila do gerador assíncrono, sem disputa"},
+    {"fila_dinamica.contar_tipo", 1 << 20, prepararVarreduraFilas, executarVarreduraFilaDinamica, liberarVarreduraFilas,
+     1 << 20, "conta as peças I percorrendo o vetor de peças"},
+    {"fila_pecas.contar_tipo", 1 << 20, prepararVarreduraFilas, executarVarreduraFilaPecas, liberarVarreduraFilas,
+     1 << 20, "conta as peças I percorrendo só o vetor de tipos"},
+    {"estatisticas.acumular[escalar]", 1 << 20, prepararEstatisticasEscalar, executarEstatisticas, liberarEstatisticas,
+     1 << 20, "frequência, secas de I e sacos de 7 sobre o vetor de tipos"},
+    {"estatisticas.acumular[ssse3]", 1 << 20, prepararEstatisticasSsse3, executarEstatisticas, liberarEstatisticas,
+     1 << 20, NULL},
+    {"estatisticas.acumular[avx2]", 1 << 20, prepararEstatisticasAvx2, executarEstatisticas, liberarEstatisticas,
+     1 << 20, NULL},
+    {"arena.alocar+reiniciar", 64, prepararArena, executarArena, liberarArenaContexto, 64,
+     "estados de rascunho descartados de uma vez"},
+    {"pool.alocar+devolver", 64, prepararPool, executarPool, liberarArenaContexto, 2 * 64, "blocos do tamanho de um estado"},
+    {"malloc+free", 64, prepararArena, executarMalloc, liberarArenaContexto, 2 * 64, "referência para os dois acima"},
+    {"salvamento.capturar", HISTORICO_MAX, prepararSalvamento, executarCapturaSalvamento, liberarSalvamento, 1,
+     "cópia do estado para o buffer do jogo"},
+    {"salvamento.carregar", HISTORICO_MAX, prepararSalvamento, executarCargaSalvamento, liberarSalvamento, 1,
+     "open + mmap + conferência + cópia"},
+    {"pilha.empilhar+desempilhar", TAMANHO_PILHA, prepararPilha, executarPilha, NULL, 2 * TAMANHO_PILHA,
+     "enche e esvazia"},
+    {"historico.adicionar", HISTORICO_MAX, prepararHistorico, executarAdicionarHistorico, liberarHistoricoContexto, 1,
+     "buffer circular cheio: sobrescreve o mais antigo"},
+    {"historico.adicionar", 1024, prepararHistorico, executarAdicionarHistorico, liberarHistoricoContexto, 1,
+     "buffer circular cheio: sobrescreve o mais antigo"},
+    {"historico.adicionar", 1 << 20, prepararHistorico, executarAdicionarHistorico, liberarHistoricoContexto, 1,
+     "buffer circular cheio: sobrescreve o mais antigo"},
+    {"historico.adicionar+remover", HISTORICO_MAX, prepararHistorico, executarAdicionarRemoverHistorico,
+     liberarHistoricoContexto, 2, NULL},
+    {"trocarPecaFilaPilha", TAMANHO_FILA + TAMANHO_PILHA, prepararFilaPilha, executarTroca, NULL, 1, NULL},
+    {"trocarPecasFilaPilha(3)", TAMANHO_FILA + TAMANHO_PILHA, prepararFilaPilha, executarTrocaBloco, NULL, 1, NULL},
+    {"inverterFilaComPilha", TAMANHO_FILA + TAMANHO_PILHA, prepararFilaPilha, executarInversao, NULL, 1, NULL},
+    {"inverterFilaComPilha+copia", TAMANHO_FILA + TAMANHO_PILHA, prepararFilaPilha, executarInversaoComCopia, NULL, 1,
+     "restaura o estado antes de cada chamada, para comparar com a versão legada"},
+    {"inverterLegado+copia", TAMANHO_FILA + TAMANHO_PILHA, prepararFilaPilha, executarInversaoLegadaComCopia, NULL, 1,
+     "inversão original com quatro laços e estruturas temporárias"},
+};
+
+#define TOTAL_CASOS ((int) (sizeof(CASOS) / sizeof(CASOS[0])))
+
+// Resumo estatístico de uma amostra
+typedef struct {
+    double minimo;
+    double mediana;
+    double media;
+    double desvio;
+    double maximo;
+} Resumo;
+
+static int compararDouble(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static Resumo resumir(double *valores, int quantidade) {
+    Resumo resumo;
+    qsort(valores, quantidade, sizeof(double), compararDouble);
+
+    double soma = 0;
+    for (int i = 0; i < quantidade; i++) soma += valores[i];
+    resumo.media = soma / quantidade;
+
+    double quadrados = 0;
+    for (int i = 0; i < quantidade; i++) quadrados += (valores[i] - resumo.media) * (valores[i] - resumo.media);
+    resumo.desvio = quantidade > 1 ? sqrt(quadrados / (quantidade - 1)) : 0.0;
+
+    resumo.minimo = valores[0];
+    resumo.maximo = valores[quantidade - 1];
+    resumo.mediana = quantidade % 2 ? valores[quantidade / 2]
+                                    : (valores[quantidade / 2 - 1] + valores[quantidade / 2]) / 2;
+    return resumo;
+}
+
+// Resultado de um caso
+typedef struct {
+    long iteracoes;             // iterações por repetição, após a calibração
+    Resumo nsPorOperacao;
+    double ciclosPorOperacao;   // mediana; negativo se não houver contador
+} ResultadoCaso;
+
+// Mede um caso: calibra as iterações até uma repetição durar o tempo mínimo
+// (isso também serve de aquecimento), descarta mais uma repetição e mede
+static int medirCaso(const CasoBenchmark *caso, int repeticoes, double tempoMinimoMs, int contador,
+                     ResultadoCaso *resultado) {
+    static Contexto contexto;
+    memset(&contexto, 0, sizeof(contexto));
+    contexto.capacidade = caso->capacidade;
+    if (!caso->preparar(&contexto)) return 0;
+
+    long iteracoes = 1;
+    for (;;) {
+        double inicio = (double) relogioNs();
+        caso->executar(&contexto, iteracoes);
+        if ((double) relogioNs() - inicio >= tempoMinimoMs * 1e6 || iteracoes > (1L << 40)) break;
+        iteracoes *= 2;
+    }
+    caso->executar(&contexto, iteracoes);
+
+    double nsPorOperacao[MAX_REPETICOES];
+    double ciclos[MAX_REPETICOES];
+    double operacoes = (double) iteracoes * caso->operacoesPorIteracao;
+
+    for (int r = 0; r < repeticoes; r++) {
+        if (contador >= 0) {
+            ioctl(contador, PERF_EVENT_IOC_RESET, 0);
+            ioctl(contador, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        double inicio = (double) relogioNs();
+        caso->executar(&contexto, iteracoes);
+        double fim = (double) relogioNs();
+        if (contador >= 0) ioctl(contador, PERF_EVENT_IOC_DISABLE, 0);
+
+        nsPorOperacao[r] = (fim - inicio) / operacoes;
+        ciclos[r] = contador >= 0 ? lerContador(contador) / operacoes : -1;
+    }
+
+    if (caso->liberar != NULL) caso->liberar(&contexto);
+
+    resultado->iteracoes = iteracoes;
+    resultado->nsPorOperacao = resumir(nsPorOperacao, repeticoes);
+    resultado->ciclosPorOperacao = contador >= 0 ? resumir(ciclos, repeticoes).mediana : -1;
+    return 1;
+}
+
+static void escreverJson(FILE *saida, const ResultadoCaso *resultados, const int *medidos, int repeticoes,
+                         double tempoMinimoMs, int temContador) {
+    fprintf(saida, "{\n");
+    fprintf(saida, "  \"ambiente\": {\"compilador\": \"%s\", \"repeticoes\": %d, \"tempo_minimo_ms\": %.1f, "
+                   "\"contador_ciclos\": %s},\n",
+            __VERSION__, repeticoes, tempoMinimoMs, temContador ? "true" : "false");
+    fprintf(saida, "  \"resultados\": [");
+
+    int primeiro = 1;
+    for (int i = 0; i < TOTAL_CASOS; i++) {
+        if (!medidos[i]) continue;
+        const ResultadoCaso *resultado = &resultados[i];
+        const Resumo *ns = &resultado->nsPorOperacao;
+
+        fprintf(saida, "%s\n    {\"caso\": \"%s\", \"capacidade\": %d, \"iteracoes\": %ld, "
+                       "\"operacoes_por_iteracao\": %d,\n",
+                primeiro ? "" : ",", CASOS[i].nome, CASOS[i].capacidade, resultado->iteracoes,
+                CASOS[i].operacoesPorIteracao);
+        fprintf(saida, "     \"ns_por_op\": {\"min\": %.4f, \"mediana\": %.4f, \"media\": %.4f, "
+                       "\"desvio\": %.4f, \"max\": %.4f},\n",
+                ns->minimo, ns->mediana, ns->media, ns->desvio, ns->maximo);
+        fprintf(saida, "     \"milhoes_ops_por_s\": %.3f, ", 1e3 / ns->mediana);
+        if (resultado->ciclosPorOperacao >= 0) {
+            fprintf(saida, "\"ciclos_por_op\": %.3f}", resultado->ciclosPorOperacao);
+        } else {
+            fprintf(saida, "\"ciclos_por_op\": null}");
+        }
+        primeiro = 0;
+    }
+    fprintf(saida, "\n  ]\n}\n");
+}
+
+int main(int argc, char *argv[]) {
+    int repeticoes = REPETICOES_PADRAO;
+    double tempoMinimoMs = TEMPO_MINIMO_PADRAO_MS;
+    const char *filtro = NULL;
+    const char *caminhoJson = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeticoes") == 0 && i + 1 < argc) {
+            repeticoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tempo-min") == 0 && i + 1 < argc) {
+            tempoMinimoMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) {
+            filtro = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            caminhoJson = argv[++i];
+        } else {
+            fprintf(stderr, "Uso: %s [--repeticoes N] [--tempo-min MS] [--filtro TEXTO] [--json ARQUIVO|-]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (repeticoes < 1) repeticoes = 1;
+    if (repeticoes > MAX_REPETICOES) repeticoes = MAX_REPETICOES;
+
+    // Com o JSON na saída padrão a tabela vai para a saída de erros
+    FILE *tabela = caminhoJson != NULL && strcmp(caminhoJson, "-") == 0 ? stderr : stdout;
+    int contador = abrirContadorCiclos();
+
+    fprintf(tabela, "=== BENCHMARK DAS ESTRUTURAS (%d repetições, contador de ciclos: %s) ===\n",
+            repeticoes, contador >= 0 ? "sim" : "indisponível");
+    fprintf(tabela, "%-40s %8s %10s %10s %10s %8s %10s\n",
+            "Caso", "Capac.", "ns/op", "mín", "desvio", "ciclos", "Mops/s");
+
+    ResultadoCaso resultados[TOTAL_CASOS];
+    int medidos[TOTAL_CASOS] = {0};
+
+    for (int i = 0; i < TOTAL_CASOS; i++) {
+        if (filtro != NULL && strstr(CASOS[i].nome, filtro) == NULL) continue;
+
+        if (!medirCaso(&CASOS[i], repeticoes, tempoMinimoMs, contador, &resultados[i])) {
+            fprintf(stderr, "⚠️  Caso %s ignorado (memória insuficiente ou CPU sem suporte)\n", CASOS[i].nome);
+            continue;
+        }
+        medidos[i] = 1;
+
+        const Resumo *ns = &resultados[i].nsPorOperacao;
+        char ciclos[16] = "-";
+        if (resultados[i].ciclosPorOperacao >= 0) snprintf(ciclos, sizeof(ciclos), "%.1f", resultados[i].ciclosPorOperacao);
+        fprintf(tabela, "%-40s %8d %10.3f %10.3f %10.3f %8s %10.1f\n", CASOS[i].nome, CASOS[i].capacidade,
+                ns->mediana, ns->minimo, ns->desvio, ciclos, 1e3 / ns->mediana);
+        fflush(tabela);
+    }
+
+    if (caminhoJson != NULL) {
+        FILE *saida = strcmp(caminhoJson, "-") == 0 ? stdout : fopen(caminhoJson, "w");
+        if (saida == NULL) {
+            perror(caminhoJson);
+            return 1;
+        }
+        escreverJson(saida, resultados, medidos, repeticoes, tempoMinimoMs, contador >= 0);
+        if (saida != stdout) {
+            fclose(saida);
+            fprintf(tabela, "📝 Resultados gravados em %s\n", caminhoJson);
+        }
+    }
+
+    if (contador >= 0) close(contador);
+    return 0;
+}
@@ -1,419 +1,884 @@
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-#define TAMANHO_FILA 5
-#define TAMANHO_PILHA 3
-#define HISTORICO_MAX 10
+#include "entrada.h"
+#include "gravacao.h"
+#include "ia.h"
+#include "metricas.h"
+#include "motor.h"
+#include "roteiro.h"
+#include "salvamento.h"
+#include "tela.h"
+#include "versoes.h"
 
-// Estrutura para representar uma peça do Tetris
-typedef struct {
-    char tipo;      // 'I', 'O', 'T', 'L'
-    int id;         // identificador único
-} Peca;
+#define HZ_PADRAO 60
+#define QUEDA_PADRAO_MS 1000
+#define JOGADAS_BOT_PADRAO 1000
+#define INTERVALO_SALVAMENTO_PADRAO_MS 1000
 
-// Estrutura para a fila circular
-typedef struct {
-    Peca pecas[TAMANHO_FILA];
-    int frente;
-    int tras;
-    int quantidade;
-} FilaCircular;
+// Opção do menu que só mostra as métricas (não é uma ação do motor)
+#define OPCAO_METRICAS 12
 
-// Estrutura para a pilha de reserva
-typedef struct {
-    Peca pecas[TAMANHO_PILHA];
-    int topo;
-    int quantidade;
-} PilhaReserva;
+// Opções da árvore de versões (--versoes); a opção 5 passa a voltar uma versão
+#define OPCAO_REFAZER 13
+#define OPCAO_TROCAR_RAMO 14
 
-// Estrutura para o histórico de ações
-typedef struct {
-    char acao[50];
-    Peca pecaFilaFrente;
-    Peca pecaPilhaTopo;
-    int timestamp;
-} AcaoHistorico;
+// Marca de uma entrada que não é um número (nada é executado)
+#define OPCAO_ENTRADA_INVALIDA -2
 
-// Estrutura para o histórico do jogo
+// Estatísticas de ritmo do modo em tempo real
 typedef struct {
-    AcaoHistorico historico[HISTORICO_MAX];
-    int topo;
-    int quantidade;
-} HistoricoJogo;
+    long ticks;
+    long quadros;
+    long ressincronizacoes;     // vezes em que o laço atrasou demais e recomeçou a contagem
+    int64_t somaDesvioNs;       // atraso do início de cada tick em relação ao previsto
+    int64_t maxDesvioNs;
+    long teclas;
+    int64_t somaLatenciaNs;     // da leitura da tecla até o envio do quadro com o efeito
+    int64_t maxLatenciaNs;
+} EstatisticasLaco;
 
-// Função para gerar uma peça aleatória
-Peca gerarPeca() {
-    Peca novaPeca;
-    char tipos[] = {'I', 'O', 'T', 'L'};
+static volatile sig_atomic_t interrompido = 0;
+static volatile sig_atomic_t pedidoMetricas = 0;    // SIGUSR1 recebido
+static const char *arquivoMetricas = NULL;          // destino do JSON de --metricas
+static SalvamentoAutomatico salvamento;
+static int salvamentoAtivo = 0;                     // --salvar
+
+// Funções de visualização (montam o painel no quadro da tela)
+void desenharFila(Tela *tela, FilaCircular *fila) {
+    escreverLinha(tela, "=== FILA DE PEÇAS FUTURAS ===");
     
-    novaPeca.id = rand() % 1000 + 1;
-    novaPeca.tipo = tipos[rand() % 4];
+    if (filaVazia(fila)) {
+        escreverLinha(tela, "Fila vazia!");
+        return;
+    }
     
-    return novaPeca;
+    for (int i = 0; i < fila->quantidade; i++) {
+        Peca *peca = posicaoFila(fila, i);
+        escreverLinha(tela, "Posição %d: Peça '%c' (ID: %d)", i + 1, letraPeca(*peca), peca->id);
+    }
+    escreverLinha(tela, "Total: %d/%d peças", fila->quantidade, capacidadeFila(fila));
+}
+
+void desenharPilha(Tela *tela, PilhaReserva *pilha) {
+    escreverLinha(tela, "=== PILHA DE RESERVA ===");
+    
+    if (pilhaVazia(pilha)) {
+        escreverLinha(tela, "Pilha vazia!");
+    } else {
+        for (int i = pilha->topo; i >= 0; i--) {
+            escreverLinha(tela, "Reserva %d: Peça '%c' (ID: %d)", 
+                          pilha->topo - i + 1, letraPeca(pilha->pecas[i]), pilha->pecas[i].id);
+        }
+    }
+    escreverLinha(tela, "Total: %d/%d peças", pilha->quantidade, TAMANHO_PILHA);
 }
 
-// Função para inicializar a fila circular
-void inicializarFila(FilaCircular *fila) {
-    fila->frente = 0;
-    fila->tras = -1;
-    fila->quantidade = 0;
+// Desenha o tabuleiro com a mira da próxima peça acima dele
+void desenharTabuleiro(Tela *tela, EstadoJogo *estado) {
+    Tabuleiro *tabuleiro = &estado->tabuleiro;
+    const FormaPeca *forma = formaPeca(verFrenteFila(&estado->fila).tipo, estado->rotacaoMira);
+    int inicioMira = estado->colunaMira;
+    if (inicioMira > tabuleiro->largura - forma->largura) inicioMira = tabuleiro->largura - forma->largura;
+    
+    char linha[LARGURA_MAXIMA + 3];
+    linha[0] = ' ';
+    for (int c = 0; c < tabuleiro->largura; c++) {
+        linha[c + 1] = (c >= inicioMira && c < inicioMira + forma->largura) ? 'v' : ' ';
+    }
+    linha[tabuleiro->largura + 1] = '\0';
+    escreverLinha(tela, "%s", linha);
+    
+    for (int r = tabuleiro->altura - 1; r >= 0; r--) {
+        linha[0] = '|';
+        for (int c = 0; c < tabuleiro->largura; c++) {
+            linha[c + 1] = (tabuleiro->linhas[r] >> c) & 1 ? '#' : '.';
+        }
+        linha[tabuleiro->largura + 1] = '|';
+        linha[tabuleiro->largura + 2] = '\0';
+        escreverLinha(tela, "%s", linha);
+    }
     
-    for (int i = 0; i < TAMANHO_FILA; i++) {
-        fila->pecas[i] = gerarPeca();
-        fila->tras = (fila->tras + 1) % TAMANHO_FILA;
-        fila->quantidade++;
+    linha[0] = '+';
+    for (int c = 0; c < tabuleiro->largura; c++) {
+        linha[c + 1] = '-';
     }
+    linha[tabuleiro->largura + 1] = '+';
+    linha[tabuleiro->largura + 2] = '\0';
+    escreverLinha(tela, "%s", linha);
+    escreverLinha(tela, "Linhas: %ld", estado->linhasRemovidas);
 }
 
-// Função para inicializar a pilha de reserva
-void inicializarPilha(PilhaReserva *pilha) {
-    pilha->topo = -1;
-    pilha->quantidade = 0;
+// Monta o painel: tabuleiro à esquerda, fila e pilha à direita
+void montarPainel(Tela *tela, EstadoJogo *estado) {
+    desenharTabuleiro(tela, estado);
+    
+    posicionarEscrita(tela, 0, estado->tabuleiro.largura + 6);
+    escreverLinha(tela, "");
+    desenharFila(tela, &estado->fila);
+    escreverLinha(tela, "");
+    desenharPilha(tela, &estado->pilha);
+    
+    posicionarEscrita(tela, tela->totalLinhas, 0);
 }
 
-// Função para inicializar o histórico
-void inicializarHistorico(HistoricoJogo *historico) {
-    historico->topo = -1;
-    historico->quantidade = 0;
+// Monta e envia o painel (só as linhas alteradas)
+void desenharPainel(Tela *tela, EstadoJogo *estado) {
+    iniciarQuadro(tela);
+    montarPainel(tela, estado);
+    finalizarQuadro(tela, stdout);
 }
 
-// Funções de verificação de estado
-int filaVazia(FilaCircular *fila) {
-    return fila->quantidade == 0;
+void visualizarHistorico(HistoricoJogo *historico) {
+    printf("\n=== HISTÓRICO (últimas %zu ações) ===\n", historico->quantidade);
+    
+    if (historicoVazio(historico)) {
+        printf("Nenhuma ação no histórico.\n");
+        return;
+    }
+    
+    for (size_t i = 0; i < historico->quantidade; i++) {
+        RegistroHistorico *registro = registroHistorico(historico, i);
+        printf("#%zu: %s (Peça '%c', ID: %d)\n", i + 1, descricaoAcao((AcaoJogo) registro->acao),
+               letraPeca(registro->pecaA), registro->pecaA.id);
+    }
 }
 
-int filaCheia(FilaCircular *fila) {
-    return fila->quantidade == TAMANHO_FILA;
+// Função para mostrar o menu
+void mostrarMenu(int versoes) {
+    printf("\n=== TETRIS - NÍVEL MESTRE ===\n");
+    printf("1 - Jogar peça (da frente da fila)\n");
+    printf("2 - Reservar peça (da frente da fila)\n");
+    printf("3 - Usar peça reservada (do topo da pilha)\n");
+    printf("4 - Trocar peça (topo da pilha ↔ frente da fila)\n");
+    printf(versoes ? "5 - Desfazer (voltar uma versão)\n" : "5 - Desfazer última jogada\n");
+    printf("6 - Inverter fila com pilha\n");
+    printf("7 - Visualizar histórico\n");
+    printf("8 - Trocar 3 primeiros da fila com as 3 peças da pilha\n");
+    printf("9 - Mover a mira para a esquerda\n");
+    printf("10 - Mover a mira para a direita\n");
+    printf("11 - Girar a peça (sentido horário)\n");
+    printf("12 - Ver métricas das ações\n");
+    if (versoes) {
+        printf("13 - Refazer\n");
+        printf("14 - Ir para o próximo ramo\n");
+    }
+    printf("0 - Sair do jogo\n");
+    printf("Escolha uma opção: ");
 }
 
-int pilhaVazia(PilhaReserva *pilha) {
-    return pilha->quantidade == 0;
+// Informa quantas linhas a última peça completou
+void mostrarLinhasCompletas(EstadoJogo *estado) {
+    RegistroHistorico *ultimo = registroHistorico(&estado->historico, 0);
+    if (ultimo != NULL && ultimo->linhasLimpas != 0) {
+        printf("✨ Linhas completas: %d\n", __builtin_popcount(ultimo->linhasLimpas));
+    }
 }
 
-int pilhaCheia(PilhaReserva *pilha) {
-    return pilha->quantidade == TAMANHO_PILHA;
+// Função para informar ao jogador o resultado de uma ação
+void mostrarResultado(EstadoJogo *estado, AcaoJogo acao, ResultadoAcao resultado) {
+    Peca afetada = estado->pecaAfetada;
+    Peca nova = estado->pecaNova;
+    
+    switch (resultado) {
+        case RESULTADO_FILA_VAZIA:
+            printf("❌ Fila vazia!\n");
+            return;
+        case RESULTADO_PILHA_CHEIA:
+            printf("❌ Fila vazia ou pilha cheia!\n");
+            return;
+        case RESULTADO_PILHA_VAZIA:
+            printf("❌ Pilha vazia!\n");
+            return;
+        case RESULTADO_ESTRUTURAS_VAZIAS:
+            if (acao == ACAO_TROCAR) {
+                printf("❌ Não é possível trocar: fila ou pilha vazia!\n");
+            } else {
+                printf("❌ Não é possível inverter: ambas estruturas vazias!\n");
+            }
+            return;
+        case RESULTADO_PECAS_INSUFICIENTES:
+            printf("❌ Não é possível trocar: a pilha precisa de %d peças e a fila de ao menos %d!\n",
+                   TAMANHO_PILHA, TAMANHO_PILHA);
+            return;
+        case RESULTADO_HISTORICO_VAZIO:
+            printf("❌ Nada para desfazer!\n");
+            return;
+        case RESULTADO_FIM_DE_JOGO:
+            printf("💀 A peça não cabe mais no tabuleiro: fim de jogo! (desfaça para continuar)\n");
+            return;
+        case RESULTADO_LIMITE_TABULEIRO:
+            printf(acao == ACAO_GIRAR ? "❌ Não há espaço para girar a peça!\n"
+                                      : "❌ A mira já está na borda do tabuleiro!\n");
+            return;
+        case RESULTADO_ACAO_INVALIDA:
+            printf("\n❌ Opção inválida!\n");
+            return;
+        case RESULTADO_OK:
+            break;
+    }
+    
+    switch (acao) {
+        case ACAO_JOGAR:
+            printf("\n🎮 Peça jogada: '%c' (ID: %d)\n", letraPeca(afetada), afetada.id);
+            mostrarLinhasCompletas(estado);
+            printf("➕ Nova peça: '%c' (ID: %d)\n", letraPeca(nova), nova.id);
+            break;
+        case ACAO_RESERVAR:
+            printf("\n💾 Peça reservada: '%c' (ID: %d)\n", letraPeca(afetada), afetada.id);
+            printf("➕ Nova peça: '%c' (ID: %d)\n", letraPeca(nova), nova.id);
+            break;
+        case ACAO_USAR_RESERVA:
+            printf("\n🎮 Peça usada da reserva: '%c' (ID: %d)\n", letraPeca(afetada), afetada.id);
+            mostrarLinhasCompletas(estado);
+            break;
+        case ACAO_TROCAR:
+            printf("🔄 Troca realizada: Fila('%c'↔'%c')Pilha\n", letraPeca(afetada), letraPeca(nova));
+            break;
+        case ACAO_MOVER_ESQUERDA:
+        case ACAO_MOVER_DIREITA:
+            printf("\n🎯 Mira na coluna %d\n", estado->colunaMira + 1);
+            break;
+        case ACAO_GIRAR:
+            printf("\n🔃 Peça girada: rotação %d, mira na coluna %d\n", estado->rotacaoMira, estado->colunaMira + 1);
+            break;
+        case ACAO_TROCAR_BLOCO:
+            printf("🔄 Troca em bloco realizada: %d primeiras da fila ↔ %d da pilha\n",
+                   TAMANHO_PILHA, TAMANHO_PILHA);
+            break;
+        case ACAO_DESFAZER:
+            printf("\n↩️  Desfeito: %s\n", descricaoAcao((AcaoJogo) estado->acaoDesfeita.acao));
+            printf("   Estado restaurado - Fila: '%c', Pilha: '%c'\n", 
+                   letraPeca(verFrenteFila(&estado->fila)), letraPeca(verTopoPilha(&estado->pilha)));
+            break;
+        case ACAO_INVERTER:
+            printf("🔄 Inversão completa: Fila↔Pilha\n");
+            break;
+        case ACAO_SAIR:
+            printf("\n👋 Obrigado por jogar Tetris Mestre!\n");
+            break;
+        default:
+            break;
+    }
 }
 
-int historicoVazio(HistoricoJogo *historico) {
-    return historico->quantidade == 0;
+// Texto curto do resultado de uma ação, para a linha de estado do modo em tempo real
+const char *textoResultado(AcaoJogo acao, ResultadoAcao resultado) {
+    switch (resultado) {
+        case RESULTADO_OK:                  return descricaoAcao(acao);
+        case RESULTADO_FILA_VAZIA:          return "❌ Fila vazia!";
+        case RESULTADO_PILHA_CHEIA:         return "❌ Pilha cheia!";
+        case RESULTADO_PILHA_VAZIA:         return "❌ Pilha vazia!";
+        case RESULTADO_FIM_DE_JOGO:         return "💀 A peça não cabe mais: fim de jogo!";
+        case RESULTADO_LIMITE_TABULEIRO:    return acao == ACAO_GIRAR ? "❌ Sem espaço para girar!" : "❌ A mira já está na borda!";
+        case RESULTADO_ESTRUTURAS_VAZIAS:   return "❌ Fila ou pilha vazia!";
+        case RESULTADO_PECAS_INSUFICIENTES: return "❌ Peças insuficientes para a troca!";
+        case RESULTADO_HISTORICO_VAZIO:     return "❌ Nada para desfazer!";
+        default:                            return "❌ Opção inválida!";
+    }
 }
 
-int historicoCheio(HistoricoJogo *historico) {
-    return historico->quantidade == HISTORICO_MAX;
+void tratarInterrupcao(int sinal) {
+    (void) sinal;
+    interrompido = 1;
 }
 
-// Funções da fila circular
-void enfileirar(FilaCircular *fila, Peca peca) {
-    if (filaCheia(fila)) return;
-    
-    fila->tras = (fila->tras + 1) % TAMANHO_FILA;
-    fila->pecas[fila->tras] = peca;
-    fila->quantidade++;
+void tratarPedidoMetricas(int sinal) {
+    (void) sinal;
+    pedidoMetricas = 1;
 }
 
-Peca desenfileirar(FilaCircular *fila) {
-    Peca pecaVazia = {'?', -1};
-    if (filaVazia(fila)) return pecaVazia;
-    
-    Peca pecaRemovida = fila->pecas[fila->frente];
-    fila->frente = (fila->frente + 1) % TAMANHO_FILA;
-    fila->quantidade--;
+// Despeja as métricas: em JSON no arquivo de --metricas ou, sem ele, como
+// tabela na saída de erros (para não misturar com o painel)
+static void despejarMetricas(const EstadoJogo *estado) {
+    if (arquivoMetricas == NULL) {
+        mostrarMetricas(estado->metricas, stderr);
+        return;
+    }
     
-    return pecaRemovida;
+    FILE *arquivo = fopen(arquivoMetricas, "w");
+    if (arquivo == NULL) {
+        perror(arquivoMetricas);
+        return;
+    }
+    exportarMetricasJson(estado->metricas, arquivo);
+    fclose(arquivo);
 }
 
-Peca verFrenteFila(FilaCircular *fila) {
-    Peca pecaVazia = {'?', -1};
-    if (filaVazia(fila)) return pecaVazia;
-    return fila->pecas[fila->frente];
+// Atende um SIGUSR1 recebido desde a última verificação (a cada tick, jogada
+// do bot ou opção do menu)
+static void atenderPedidoMetricas(const EstadoJogo *estado) {
+    if (!pedidoMetricas) return;
+    pedidoMetricas = 0;
+    despejarMetricas(estado);
 }
 
-// Funções da pilha de reserva
-void empilhar(PilhaReserva *pilha, Peca peca) {
-    if (pilhaCheia(pilha)) return;
-    
-    pilha->topo++;
-    pilha->pecas[pilha->topo] = peca;
-    pilha->quantidade++;
+// Entrega o estado à thread de salvamento automático, se houver uma (depois
+// de cada tick com alguma ação, jogada do bot ou opção do menu)
+static void atenderSalvamento(const EstadoJogo *estado) {
+    if (salvamentoAtivo) salvarAutomatico(&salvamento, estado);
 }
 
-Peca desempilhar(PilhaReserva *pilha) {
-    Peca pecaVazia = {'?', -1};
-    if (pilhaVazia(pilha)) return pecaVazia;
+// Modo em tempo real: passo fixo de simulação, entrada sem bloqueio e
+// redesenho a cada tick. Entrada, simulação e desenho são etapas separadas do
+// laço: as teclas são lidas enquanto se espera o próximo tick, aplicadas no
+// tick e o quadro é enviado logo depois. A cada "quedaMs" a peça da frente cai
+// sozinha (é jogada), mesmo sem nenhuma tecla.
+void jogarTempoReal(EstadoJogo *estado, Tela *tela, int hz, int quedaMs, EstatisticasLaco *estatisticas) {
+    const int64_t passo = 1000000000LL / hz;
+    const long ticksPorQueda = quedaMs * (long) hz / 1000 > 0 ? quedaMs * (long) hz / 1000 : 1;
+    
+    int teclasPendentes[64];
+    int64_t chegadaTeclas[64];
+    int totalPendentes = 0;
+    long ticksDesdeQueda = 0;
+    const char *estadoTexto = "Boa partida!";
+    int sair = 0;
     
-    Peca pecaRemovida = pilha->pecas[pilha->topo];
-    pilha->topo--;
-    pilha->quantidade--;
+    memset(estatisticas, 0, sizeof(*estatisticas));
+    int64_t proximoTick = relogioNs();
     
-    return pecaRemovida;
+    while (!sair && !interrompido) {
+        atenderPedidoMetricas(estado);
+        
+        // Entrada: lê teclas até a hora do próximo tick
+        int64_t agora = relogioNs();
+        int tecla = lerTecla(agora < proximoTick ? proximoTick - agora : 0);
+        if (tecla == TECLA_FIM) break;
+        if (tecla != TECLA_NENHUMA && totalPendentes < 64) {
+            teclasPendentes[totalPendentes] = tecla;
+            chegadaTeclas[totalPendentes] = relogioNs();
+            totalPendentes++;
+        }
+        
+        agora = relogioNs();
+        if (agora < proximoTick) continue;
+        
+        // Simulação: um passo fixo
+        int64_t desvio = agora - proximoTick;
+        estatisticas->ticks++;
+        estatisticas->somaDesvioNs += desvio;
+        if (desvio > estatisticas->maxDesvioNs) estatisticas->maxDesvioNs = desvio;
+        
+        int agiu = 0;
+        for (int i = 0; i < totalPendentes; i++) {
+            int t = teclasPendentes[i];
+            if (t == 'q' || t == '0') {
+                sair = 1;
+            } else if ((t >= '1' && t <= '8' && t - '0' != ACAO_VISUALIZAR_HISTORICO) || t == 'a' || t == 'd' || t == 'w') {
+                AcaoJogo acao = t == 'a' ? ACAO_MOVER_ESQUERDA : t == 'd' ? ACAO_MOVER_DIREITA :
+                                t == 'w' ? ACAO_GIRAR : (AcaoJogo) (t - '0');
+                estadoTexto = textoResultado(acao, executarAcao(estado, acao));
+                if (acao == ACAO_JOGAR) ticksDesdeQueda = 0;
+                agiu = 1;
+            }
+        }
+        
+        if (++ticksDesdeQueda >= ticksPorQueda) {
+            ResultadoAcao resultado = executarAcao(estado, ACAO_JOGAR);
+            estadoTexto = resultado == RESULTADO_OK ? "⬇️  A peça caiu!" : textoResultado(ACAO_JOGAR, resultado);
+            ticksDesdeQueda = 0;
+            agiu = 1;
+        }
+        if (agiu) atenderSalvamento(estado);
+        
+        proximoTick += passo;
+        if (agora - proximoTick > 5 * passo) {
+            // Atrasou demais (terminal lento, processo suspenso): recomeça sem tentar compensar
+            proximoTick = agora + passo;
+            estatisticas->ressincronizacoes++;
+        }
+        
+        // Desenho: só as linhas alteradas são enviadas
+        iniciarQuadro(tela);
+        montarPainel(tela, estado);
+        escreverLinha(tela, "");
+        escreverLinha(tela, "%s", estadoTexto);
+        escreverLinha(tela, "Próxima queda em %.1f s", (ticksPorQueda - ticksDesdeQueda) / (double) hz);
+        escreverLinha(tela, "Teclas: 1-6 e 8 = ações do menu | a/d = mover a mira | w = girar | q = sair");
+        finalizarQuadro(tela, stdout);
+        fflush(stdout);
+        estatisticas->quadros++;
+        
+        int64_t enviado = relogioNs();
+        for (int i = 0; i < totalPendentes; i++) {
+            int64_t latencia = enviado - chegadaTeclas[i];
+            estatisticas->teclas++;
+            estatisticas->somaLatenciaNs += latencia;
+            if (latencia > estatisticas->maxLatenciaNs) estatisticas->maxLatenciaNs = latencia;
+        }
+        totalPendentes = 0;
+    }
 }
 
-Peca verTopoPilha(PilhaReserva *pilha) {
-    Peca pecaVazia = {'?', -1};
-    if (pilhaVazia(pilha)) return pecaVazia;
-    return pilha->pecas[pilha->topo];
+void mostrarEstatisticasLaco(EstatisticasLaco *estatisticas, const Tela *tela, int hz) {
+    long ticks = estatisticas->ticks > 0 ? estatisticas->ticks : 1;
+    long teclas = estatisticas->teclas > 0 ? estatisticas->teclas : 1;
+    
+    printf("\n=== RITMO DO LAÇO (%d Hz) ===\n", hz);
+    printf("Ticks: %ld | Quadros: %ld | Ressincronizações: %ld\n",
+           estatisticas->ticks, estatisticas->quadros, estatisticas->ressincronizacoes);
+    printf("Linhas redesenhadas: %lu (média %.1f por quadro)\n", tela->linhasRedesenhadas,
+           estatisticas->quadros > 0 ? (double) tela->linhasRedesenhadas / estatisticas->quadros : 0.0);
+    printf("Desvio do tick: médio %.1f µs, máximo %.1f µs\n",
+           estatisticas->somaDesvioNs / 1e3 / ticks, estatisticas->maxDesvioNs / 1e3);
+    printf("Latência de entrada (tecla → quadro): média %.1f µs, máxima %.1f µs (%ld teclas)\n",
+           estatisticas->somaLatenciaNs / 1e3 / teclas, estatisticas->maxLatenciaNs / 1e3, estatisticas->teclas);
 }
 
-// Funções do histórico
-void adicionarHistorico(HistoricoJogo *historico, const char *acao, Peca filaFrente, Peca pilhaTopo) {
-    if (historicoCheio(historico)) {
-        // Remove a ação mais antiga (implementação simplificada)
-        for (int i = 0; i < HISTORICO_MAX - 1; i++) {
-            historico->historico[i] = historico->historico[i + 1];
+// Modo bot: o jogador automático joga sozinho até o fim de jogo ou até o
+// limite de jogadas, mostrando o painel a cada lance quando a saída é um terminal
+void jogarBot(EstadoJogo *estado, Tela *tela, const ConfiguracaoIa *configuracao, long jogadas) {
+    static Ia ia;
+    if (!iniciarIa(&ia, configuracao)) {
+        printf("Erro: não foi possível criar as threads do bot!\n");
+        return;
+    }
+    
+    long feitas = 0;
+    long nos = 0;
+    long roubos = 0;
+    long consultas = 0;
+    long acertos = 0;
+    long substituicoes = 0;
+    long estouros = 0;          // jogadas que não chegaram à profundidade pedida
+    size_t rascunho = 0;
+    int64_t somaNs = 0;
+    int64_t maxNs = 0;
+    ResultadoAcao resultado = RESULTADO_OK;
+    long alocacoesAntes = alocacoesProcesso();
+    
+    while (feitas < jogadas && !interrompido) {
+        atenderPedidoMetricas(estado);
+        DecisaoIa decisao = decidirLance(&ia, estado);
+        if (decisao.lance.tipo == LANCE_NENHUM) {
+            resultado = RESULTADO_FIM_DE_JOGO;
+            break;
+        }
+        
+        resultado = aplicarLance(estado, decisao.lance);
+        if (resultado != RESULTADO_OK) break;
+        atenderSalvamento(estado);
+        
+        feitas++;
+        nos += decisao.nos;
+        roubos += decisao.roubos;
+        consultas += decisao.consultasTabela;
+        acertos += decisao.acertosTabela;
+        substituicoes += decisao.substituicoesTabela;
+        estouros += decisao.profundidade < configuracao->profundidade;
+        if (decisao.rascunhoBytes > rascunho) rascunho = decisao.rascunhoBytes;
+        somaNs += decisao.duracaoNs;
+        if (decisao.duracaoNs > maxNs) maxNs = decisao.duracaoNs;
+        
+        if (tela->ansi) {
+            iniciarQuadro(tela);
+            montarPainel(tela, estado);
+            escreverLinha(tela, "");
+            escreverLinha(tela, "🤖 Jogada %ld: profundidade %d, %ld tabuleiros em %.2f ms",
+                          feitas, decisao.profundidade, decisao.nos, decisao.duracaoNs / 1e6);
+            finalizarQuadro(tela, stdout);
+            fflush(stdout);
         }
-        historico->quantidade--;
     }
     
-    historico->topo = (historico->topo + 1) % HISTORICO_MAX;
-    strcpy(historico->historico[historico->topo].acao, acao);
-    historico->historico[historico->topo].pecaFilaFrente = filaFrente;
-    historico->historico[historico->topo].pecaPilhaTopo = pilhaTopo;
-    historico->historico[historico->topo].timestamp = rand() % 10000;
-    historico->quantidade++;
+    long alocacoes = alocacoesProcesso() - alocacoesAntes;
+    encerrarIa(&ia);
+    
+    long divisor = feitas > 0 ? feitas : 1;
+    printf("\n=== BOT (%d threads, profundidade %d, orçamento %.1f ms) ===\n",
+           ia.configuracao.threads, configuracao->profundidade, configuracao->orcamentoMs);
+    printf("Jogadas: %ld | Linhas: %ld%s\n", feitas, estado->linhasRemovidas,
+           resultado == RESULTADO_FIM_DE_JOGO ? " | 💀 Fim de jogo" : "");
+    printf("Decisão: média %.2f ms, máxima %.2f ms | Fora do orçamento: %ld\n",
+           somaNs / 1e6 / divisor, maxNs / 1e6, estouros);
+    printf("Tabuleiros avaliados: %ld (%.2f milhões/s) | Tarefas roubadas: %ld\n",
+           nos, somaNs > 0 ? nos / (somaNs / 1e9) / 1e6 : 0.0, roubos);
+    if (configuracao->megabytesTabela > 0) {
+        printf("Tabela de transposição (%zu MB): %ld consultas, %.1f%% de acertos, %ld substituições\n",
+               configuracao->megabytesTabela, consultas,
+               consultas > 0 ? 100.0 * acertos / consultas : 0.0, substituicoes);
+    }
+    printf("Rascunho da busca: até %.1f KB por thread | Alocações durante as jogadas: ", rascunho / 1024.0);
+    if (alocacoesAntes < 0) {
+        printf("indisponível\n");
+    } else {
+        printf("%ld\n", alocacoes);
+    }
 }
 
-AcaoHistorico removerHistorico(HistoricoJogo *historico) {
-    AcaoHistorico vazia = {"", {'?', -1}, {'?', -1}, 0};
-    if (historicoVazio(historico)) return vazia;
+// Modo roteiro: aplica as ações de um roteiro (ver roteiro.h) sem desenhar
+// nada; no fim mostra a vazão, as rejeições por motivo e, com "resumo", o painel
+// Retorna 0 em caso de sucesso e 1 se o roteiro não pôde ser lido ou tem um comando desconhecido.
+int jogarRoteiro(EstadoJogo *estado, Tela *tela, const char *caminho, int resumo) {
+    LeitorRoteiro leitor;
+    if (!abrirRoteiro(&leitor, caminho)) {
+        printf("Erro: não foi possível abrir o roteiro %s\n", caminho);
+        return 1;
+    }
     
-    AcaoHistorico acao = historico->historico[historico->topo];
-    historico->topo--;
-    historico->quantidade--;
+    unsigned long long resultados[TOTAL_RESULTADOS] = {0};
+    long acoes = 0;
+    int lido = 0;
+    AcaoJogo acao;
+    int64_t inicio = relogioNs();
     
-    return acao;
-}
-
-// Funções das operações avançadas
-void trocarPecaFilaPilha(FilaCircular *fila, PilhaReserva *pilha) {
-    if (filaVazia(fila) || pilhaVazia(pilha)) {
-        printf("❌ Não é possível trocar: fila ou pilha vazia!\n");
-        return;
+    while (!interrompido && (lido = proximaAcaoRoteiro(&leitor, &acao)) == 1 && acao != ACAO_SAIR) {
+        resultados[executarAcao(estado, acao)]++;
+        
+        // Sinais e salvamento de tempos em tempos, fora do caminho de cada ação
+        if ((++acoes & 4095) == 0) {
+            atenderPedidoMetricas(estado);
+            atenderSalvamento(estado);
+        }
     }
     
-    Peca pecaFila = desenfileirar(fila);
-    Peca pecaPilha = desempilhar(pilha);
+    int64_t duracao = relogioNs() - inicio;
+    double segundos = duracao > 0 ? duracao / 1e9 : 1e-9;
     
-    enfileirar(fila, pecaPilha);
-    empilhar(pilha, pecaFila);
+    if (resumo) desenharPainel(tela, estado);
+    printf("\n=== ROTEIRO (%s) ===\n", strcmp(caminho, "-") == 0 ? "entrada padrão" : caminho);
+    printf("Ações: %ld | Aceitas: %llu | Rejeitadas: %llu | Linhas: %ld\n", acoes, resultados[RESULTADO_OK],
+           (unsigned long long) acoes - resultados[RESULTADO_OK], estado->linhasRemovidas);
+    printf("Tempo: %.2f ms | %.2f milhões de ações/s | %.1f MB/s lidos\n", duracao / 1e6, acoes / segundos / 1e6,
+           leitor.bytesLidos / segundos / 1e6);
+    for (int r = RESULTADO_OK + 1; r < TOTAL_RESULTADOS; r++) {
+        if (resultados[r] > 0) printf("  %-20s %llu\n", nomeResultadoMetricas((ResultadoAcao) r), resultados[r]);
+    }
+    if (lido < 0) printf("❌ Linha %ld: comando desconhecido '%s'\n", leitor.linha, leitor.comando);
     
-    printf("🔄 Troca realizada: Fila('%c'↔'%c')Pilha\n", pecaFila.tipo, pecaPilha.tipo);
+    fecharRoteiro(&leitor);
+    return lido < 0;
 }
 
-void inverterFilaComPilha(FilaCircular *fila, PilhaReserva *pilha) {
-    if (filaVazia(fila) && pilhaVazia(pilha)) {
-        printf("❌ Não é possível inverter: ambas estruturas vazias!\n");
+// Função para informar o resultado de uma navegação na árvore de versões
+void mostrarVersao(const ArvoreVersoes *versoes, int opcao, int navegou) {
+    if (!navegou) {
+        if (opcao == ACAO_DESFAZER) {
+            printf("❌ Não há nada para desfazer!\n");
+        } else if (opcao == OPCAO_REFAZER) {
+            printf("❌ Não há nada para refazer!\n");
+        } else {
+            printf("❌ Não há outro ramo a partir daqui!\n");
+        }
         return;
     }
     
-    // Salva estado atual para possível desfazer
-    PilhaReserva tempPilha;
-    FilaCircular tempFila;
-    inicializarPilha(&tempPilha);
-    inicializarFila(&tempFila);
+    int posicao;
+    int ramos = contarRamosVersao(versoes, versoes->atual, &posicao);
+    printf("🌳 Versão %u (profundidade %u, ramo %d de %d) | %zu versões guardadas\n", versoes->atual,
+           versoes->versoes[versoes->atual].profundidade, posicao, ramos, versoes->quantidadeVersoes);
+}
+
+// Fecha a gravação da partida, se houver uma, e informa onde ela ficou
+static void encerrarGravacao(GravadorPartida *gravador, const char *caminho) {
+    if (caminho == NULL) return;
+    
+    long acoes = gravador->acoes;
+    if (fecharGravacao(gravador)) {
+        printf("💾 Partida gravada em %s (%ld ações).\n", caminho, acoes);
+    } else {
+        printf("❌ Erro ao gravar a partida em %s!\n", caminho);
+    }
+}
+
+// Encerra o salvamento automático, se houver um, gravando o estado final
+static void encerrarSalvamentoAutomatico(const EstadoJogo *estado, const char *caminho) {
+    if (!salvamentoAtivo) return;
     
-    // Transfere fila para pilha temporária
-    while (!filaVazia(fila)) {
-        empilhar(&tempPilha, desenfileirar(fila));
+    salvamentoAtivo = 0;
+    if (encerrarSalvamento(&salvamento, estado)) {
+        printf("💾 Partida salva em %s (%lu gravações para %lu estados entregues).\n", caminho,
+               salvamento.gravados, salvamento.entregues);
+    } else {
+        printf("❌ Erro ao salvar a partida em %s (%lu gravações falharam)!\n", caminho, salvamento.erros);
     }
+}
+
+// Uso: TETRIS_MESTRE [--tempo-real] [--hz N] [--queda MS] [--largura N] [--altura N]
+//                    [--bot] [--jogadas N] [--profundidade N] [--threads N] [--orcamento MS]
+//                    [--tabela MB] [--gravar ARQUIVO] [--gerador-assincrono] [--metricas ARQUIVO]
+//                    [--versoes] [--salvar ARQUIVO] [--intervalo-salvamento MS]
+//                    [--roteiro ARQUIVO|-] [--resumo] [semente]
+// Com a mesma semente a partida recebe exatamente as mesmas peças. Com
+// --salvar a partida é retomada do arquivo, se ele existir, e salva nele
+// automaticamente enquanto se joga. Com --roteiro as ações vêm de um roteiro
+// em texto (ver roteiro.h), aplicadas sem desenhar nada.
+int main(int argc, char *argv[]) {
+    static Tela tela;
+    static GravadorPartida gravador;
+    static ProdutorPecas produtor;
+    static MetricasJogo metricas;
+    static ArvoreVersoes versoes;
+    const char *arquivoGravacao = NULL;
+    const char *arquivoSalvamento = NULL;
+    const char *arquivoRoteiro = NULL;
+    int resumo = 0;
+    int intervaloSalvamentoMs = INTERVALO_SALVAMENTO_PADRAO_MS;
+    EstadoJogo estado;
+    int opcao = -1;
+    int temResultado = 0;
+    int usarVersoes = 0;
+    int navegou = 0;
+    ResultadoAcao resultado = RESULTADO_OK;
+    
+    unsigned long long semente = (unsigned long long) time(NULL);
+    int tempoReal = 0;
+    int bot = 0;
+    int geradorAssincrono = 0;
+    long jogadasBot = JOGADAS_BOT_PADRAO;
+    ConfiguracaoIa configuracaoIa = configuracaoIaPadrao();
+    int hz = HZ_PADRAO;
+    int quedaMs = QUEDA_PADRAO_MS;
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
     
-    // Transfere pilha principal para fila temporária
-    while (!pilhaVazia(pilha)) {
-        enfileirar(&tempFila, desempilhar(pilha));
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tempo-real") == 0) {
+            tempoReal = 1;
+        } else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            hz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--queda") == 0 && i + 1 < argc) {
+            quedaMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--largura") == 0 && i + 1 < argc) {
+            configuracao.largura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--altura") == 0 && i + 1 < argc) {
+            configuracao.altura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bot") == 0) {
+            bot = 1;
+        } else if (strcmp(argv[i], "--jogadas") == 0 && i + 1 < argc) {
+            jogadasBot = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--profundidade") == 0 && i + 1 < argc) {
+            configuracaoIa.profundidade = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            configuracaoIa.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--orcamento") == 0 && i + 1 < argc) {
+            configuracaoIa.orcamentoMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tabela") == 0 && i + 1 < argc) {
+            configuracaoIa.megabytesTabela = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            arquivoGravacao = argv[++i];
+        } else if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            arquivoMetricas = argv[++i];
+        } else if (strcmp(argv[i], "--gerador-assincrono") == 0) {
+            geradorAssincrono = 1;
+        } else if (strcmp(argv[i], "--salvar") == 0 && i + 1 < argc) {
+            arquivoSalvamento = argv[++i];
+        } else if (strcmp(argv[i], "--intervalo-salvamento") == 0 && i + 1 < argc) {
+            intervaloSalvamentoMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--roteiro") == 0 && i + 1 < argc) {
+            arquivoRoteiro = argv[++i];
+        } else if (strcmp(argv[i], "--resumo") == 0) {
+            resumo = 1;
+        } else if (strcmp(argv[i], "--versoes") == 0) {
+            usarVersoes = 1;
+        } else {
+            semente = strtoull(argv[i], NULL, 10);
+        }
     }
+    if (hz <= 0) hz = HZ_PADRAO;
     
-    // Transfere pilha temporária para pilha principal (invertida da fila original)
-    while (!pilhaVazia(&tempPilha)) {
-        empilhar(pilha, desempilhar(&tempPilha));
+    // A árvore é o observador do motor e guarda o gerador em cada versão, então
+    // não convive com a gravação nem com o gerador numa thread à parte
+    if (usarVersoes && (bot || tempoReal || arquivoRoteiro != NULL || arquivoGravacao != NULL || geradorAssincrono)) {
+        printf("Erro: --versoes só vale no modo de menu, sem --gravar e sem --gerador-assincrono.\n");
+        return 1;
     }
     
-    // Transfere fila temporária para fila principal (invertida da pilha original)
-    while (!filaVazia(&tempFila)) {
-        enfileirar(fila, desenfileirar(&tempFila));
+    // O salvamento copia o gerador do estado, que com o gerador assíncrono
+    // fica parado (quem avança é a thread); e uma gravação precisa começar
+    // da semente, não de uma partida retomada
+    if (arquivoSalvamento != NULL && (geradorAssincrono || arquivoGravacao != NULL)) {
+        printf("Erro: --salvar não pode ser usado com --gravar nem com --gerador-assincrono.\n");
+        return 1;
     }
     
-    printf("🔄 Inversão completa: Fila↔Pilha\n");
-}
-
-// Funções de visualização
-void visualizarFila(FilaCircular *fila) {
-    printf("\n=== FILA DE PEÇAS FUTURAS ===\n");
+    configuracao.semente = semente;
     
-    if (filaVazia(fila)) {
-        printf("Fila vazia!\n");
-        return;
+    if (!inicializarJogo(&estado, &configuracao)) {
+        printf("Erro: memória insuficiente para o histórico!\n");
+        return 1;
     }
     
-    int indice = fila->frente;
-    for (int i = 0; i < fila->quantidade; i++) {
-        printf("Posição %d: Peça '%c' (ID: %d)\n", 
-               i + 1, fila->pecas[indice].tipo, fila->pecas[indice].id);
-        indice = (indice + 1) % TAMANHO_FILA;
+    // Retoma a partida salva, se houver uma, e passa a salvar em segundo plano
+    if (arquivoSalvamento != NULL) {
+        int64_t inicio = relogioNs();
+        int carregado = carregarJogo(&estado, arquivoSalvamento);
+        int64_t duracao = relogioNs() - inicio;
+        
+        if (carregado == 1) {
+            printf("💾 Partida retomada de %s em %.1f µs.\n", arquivoSalvamento, duracao / 1e3);
+        } else if (carregado < 0) {
+            printf("⚠️  %s não é um salvamento válido; começando uma partida nova.\n", arquivoSalvamento);
+        }
+        if (!iniciarSalvamento(&salvamento, arquivoSalvamento, estado.historico.capacidade, intervaloSalvamentoMs)) {
+            printf("Erro: não foi possível iniciar o salvamento automático!\n");
+            liberarJogo(&estado);
+            return 1;
+        }
+        salvamentoAtivo = 1;
     }
-    printf("Total: %d/%d peças\n", fila->quantidade, TAMANHO_FILA);
-}
-
-void visualizarPilha(PilhaReserva *pilha) {
-    printf("\n=== PILHA DE RESERVA ===\n");
     
-    if (pilhaVazia(pilha)) {
-        printf("Pilha vazia!\n");
-    } else {
-        for (int i = pilha->topo; i >= 0; i--) {
-            printf("Reserva %d: Peça '%c' (ID: %d)\n", 
-                   pilha->topo - i + 1, pilha->pecas[i].tipo, pilha->pecas[i].id);
+    // Toda ação é medida; SIGUSR1 ou a opção 12 mostram as métricas
+    inicializarMetricas(&metricas);
+    estado.metricas = &metricas;
+    signal(SIGUSR1, tratarPedidoMetricas);
+    
+    // As peças passam a ser geradas numa thread à parte, continuando do
+    // gerador recém-inicializado (a sequência não muda)
+    if (geradorAssincrono) {
+        if (!iniciarProdutor(&produtor, &estado.gerador)) {
+            printf("Erro: não foi possível criar a thread do gerador!\n");
+            encerrarSalvamentoAutomatico(NULL, arquivoSalvamento);
+            liberarJogo(&estado);
+            return 1;
         }
+        estado.produtor = &produtor;
     }
-    printf("Total: %d/%d peças\n", pilha->quantidade, TAMANHO_PILHA);
-}
-
-void visualizarHistorico(HistoricoJogo *historico) {
-    printf("\n=== HISTÓRICO (últimas %d ações) ===\n", historico->quantidade);
     
-    if (historicoVazio(historico)) {
-        printf("Nenhuma ação no histórico.\n");
-        return;
+    // A gravação acompanha o motor, então cobre os três modos de jogo
+    if (arquivoGravacao != NULL) {
+        if (!abrirGravacao(&gravador, arquivoGravacao, &configuracao)) {
+            printf("Erro: não foi possível criar %s\n", arquivoGravacao);
+            encerrarSalvamentoAutomatico(NULL, arquivoSalvamento);
+            liberarJogo(&estado);
+            return 1;
+        }
+        estado.observador = gravarAoExecutar;
+        estado.contextoObservador = &gravador;
     }
     
-    for (int i = historico->topo; i >= 0; i--) {
-        printf("#%d: %s\n", historico->topo - i + 1, historico->historico[i].acao);
+    // A partida começa como a raiz da árvore e cada ação vira uma versão
+    if (usarVersoes) {
+        if (!criarArvoreVersoes(&versoes, &estado)) {
+            printf("Erro: memória insuficiente para as versões!\n");
+            encerrarSalvamentoAutomatico(NULL, arquivoSalvamento);
+            liberarJogo(&estado);
+            return 1;
+        }
+        estado.observador = registrarAoExecutar;
+        estado.contextoObservador = &versoes;
     }
-}
-
-// Função para mostrar o menu
-void mostrarMenu() {
-    printf("\n=== TETRIS - NÍVEL MESTRE ===\n");
-    printf("1 - Jogar peça (da frente da fila)\n");
-    printf("2 - Reservar peça (da frente da fila)\n");
-    printf("3 - Usar peça reservada (do topo da pilha)\n");
-    printf("4 - Trocar peça (topo da pilha ↔ frente da fila)\n");
-    printf("5 - Desfazer última jogada\n");
-    printf("6 - Inverter fila com pilha\n");
-    printf("7 - Visualizar histórico\n");
-    printf("0 - Sair do jogo\n");
-    printf("Escolha uma opção: ");
-}
-
-int main() {
-    FilaCircular fila;
-    PilhaReserva pilha;
-    HistoricoJogo historico;
-    int opcao;
     
-    srand(time(NULL));
+    // Toda a saída de um quadro vai num único envio ao terminal
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    inicializarTela(&tela, isatty(STDOUT_FILENO));
     
-    inicializarFila(&fila);
-    inicializarPilha(&pilha);
-    inicializarHistorico(&historico);
+    if (arquivoRoteiro != NULL) {
+        // Cada ação só é medida se o JSON das métricas foi pedido
+        if (arquivoMetricas == NULL) estado.metricas = NULL;
+        signal(SIGINT, tratarInterrupcao);
+        int erro = jogarRoteiro(&estado, &tela, arquivoRoteiro, resumo);
+        if (arquivoMetricas != NULL) despejarMetricas(&estado);
+        encerrarGravacao(&gravador, arquivoGravacao);
+        encerrarSalvamentoAutomatico(&estado, arquivoSalvamento);
+        liberarJogo(&estado);
+        return erro;
+    }
     
-    printf("Bem-vindo ao Tetris - Nível Mestre!\n");
-    printf("Sistema avançado com trocas, desfazer e inversão.\n");
+    if (bot) {
+        signal(SIGINT, tratarInterrupcao);
+        jogarBot(&estado, &tela, &configuracaoIa, jogadasBot);
+        mostrarMetricas(&metricas, stdout);
+        if (arquivoMetricas != NULL) despejarMetricas(&estado);
+        encerrarGravacao(&gravador, arquivoGravacao);
+        encerrarSalvamentoAutomatico(&estado, arquivoSalvamento);
+        liberarJogo(&estado);
+        return 0;
+    }
+    
+    if (tempoReal) {
+        EntradaTerminal entrada;
+        EstatisticasLaco estatisticas;
+        
+        if (!ativarModoBruto(&entrada)) {
+            printf("Erro: o modo em tempo real precisa de um terminal.\n");
+            encerrarGravacao(&gravador, arquivoGravacao);
+            encerrarSalvamentoAutomatico(NULL, arquivoSalvamento);
+            liberarJogo(&estado);
+            return 1;
+        }
+        signal(SIGINT, tratarInterrupcao);
+        
+        jogarTempoReal(&estado, &tela, hz, quedaMs, &estatisticas);
+        
+        restaurarTerminal(&entrada);
+        mostrarEstatisticasLaco(&estatisticas, &tela, hz);
+        mostrarResultado(&estado, ACAO_SAIR, RESULTADO_OK);
+        mostrarMetricas(&metricas, stdout);
+        if (arquivoMetricas != NULL) despejarMetricas(&estado);
+        encerrarGravacao(&gravador, arquivoGravacao);
+        encerrarSalvamentoAutomatico(&estado, arquivoSalvamento);
+        liberarJogo(&estado);
+        return 0;
+    }
     
     do {
-        visualizarFila(&fila);
-        visualizarPilha(&pilha);
+        // As mensagens e o menu são escritos com printf abaixo do painel e
+        // rolam a tela, então o quadro anterior não está mais onde o
+        // renderizador pensa: cada quadro do menu é redesenhado por inteiro
+        invalidarTela(&tela);
+        desenharPainel(&tela, &estado);
         
-        mostrarMenu();
-        scanf("%d", &opcao);
+        // Mensagens abaixo do painel: boas-vindas ou resultado da última opção
+        if (opcao == -1) {
+            printf("\nBem-vindo ao Tetris - Nível Mestre!\n");
+            printf("Sistema avançado com trocas, desfazer e inversão.\n");
+            printf("Semente da partida: %llu\n", semente);
+        } else if (opcao == OPCAO_ENTRADA_INVALIDA) {
+            printf("\n❌ Opção inválida! Digite o número de uma opção.\n");
+        } else if (opcao == ACAO_VISUALIZAR_HISTORICO) {
+            visualizarHistorico(&estado.historico);
+        } else if (opcao == OPCAO_METRICAS) {
+            mostrarMetricas(&metricas, stdout);
+        } else if (usarVersoes && (opcao == ACAO_DESFAZER || opcao == OPCAO_REFAZER || opcao == OPCAO_TROCAR_RAMO)) {
+            mostrarVersao(&versoes, opcao, navegou);
+        } else if (temResultado) {
+            mostrarResultado(&estado, (AcaoJogo) opcao, resultado);
+        }
         
-        switch (opcao) {
-            case 1: {
-                // Jogar peça da fila
-                if (!filaVazia(&fila)) {
-                    Peca pecaJogada = desenfileirar(&fila);
-                    printf("\n🎮 Peça jogada: '%c' (ID: %d)\n", pecaJogada.tipo, pecaJogada.id);
-                    
-                    // Registra no histórico
-                    adicionarHistorico(&historico, "Jogou peça da fila", verFrenteFila(&fila), verTopoPilha(&pilha));
-                    
-                    // Repõe na fila
-                    Peca novaPeca = gerarPeca();
-                    enfileirar(&fila, novaPeca);
-                    printf("➕ Nova peça: '%c' (ID: %d)\n", novaPeca.tipo, novaPeca.id);
-                } else {
-                    printf("❌ Fila vazia!\n");
-                }
-                break;
-            }
-                
-            case 2: {
-                // Reservar peça da fila
-                if (!filaVazia(&fila) && !pilhaCheia(&pilha)) {
-                    Peca pecaReservada = desenfileirar(&fila);
-                    empilhar(&pilha, pecaReservada);
-                    printf("\n💾 Peça reservada: '%c' (ID: %d)\n", pecaReservada.tipo, pecaReservada.id);
-                    
-                    adicionarHistorico(&historico, "Reservou peça", verFrenteFila(&fila), verTopoPilha(&pilha));
-                    
-                    // Repõe na fila
-                    Peca novaPeca = gerarPeca();
-                    enfileirar(&fila, novaPeca);
-                    printf("➕ Nova peça: '%c' (ID: %d)\n", novaPeca.tipo, novaPeca.id);
-                } else {
-                    printf("❌ Fila vazia ou pilha cheia!\n");
-                }
-                break;
-            }
-                
-            case 3: {
-                // Usar peça da reserva
-                if (!pilhaVazia(&pilha)) {
-                    Peca pecaUsada = desempilhar(&pilha);
-                    printf("\n🎮 Peça usada da reserva: '%c' (ID: %d)\n", pecaUsada.tipo, pecaUsada.id);
-                    adicionarHistorico(&historico, "Usou peça da reserva", verFrenteFila(&fila), verTopoPilha(&pilha));
-                } else {
-                    printf("❌ Pilha vazia!\n");
-                }
-                break;
-            }
-                
-            case 4: {
-                // Trocar peça entre fila e pilha
-                Peca frenteAntes = verFrenteFila(&fila);
-                Peca topoAntes = verTopoPilha(&pilha);
-                trocarPecaFilaPilha(&fila, &pilha);
-                adicionarHistorico(&historico, "Trocou peça fila↔pilha", frenteAntes, topoAntes);
-                break;
-            }
-                
-            case 5: {
-                // Desfazer última ação
-                if (!historicoVazio(&historico)) {
-                    AcaoHistorico ultimaAcao = removerHistorico(&historico);
-                    printf("\n↩️  Desfeito: %s\n", ultimaAcao.acao);
-                    printf("   Estado anterior - Fila: '%c', Pilha: '%c'\n", 
-                           ultimaAcao.pecaFilaFrente.tipo, ultimaAcao.pecaPilhaTopo.tipo);
-                } else {
-                    printf("❌ Nada para desfazer!\n");
-                }
-                break;
-            }
-                
-            case 6: {
-                // Inverter fila com pilha
-                printf("\n🔄 Invertendo fila com pilha...\n");
-                inverterFilaComPilha(&fila, &pilha);
-                adicionarHistorico(&historico, "Inverteu fila com pilha", verFrenteFila(&fila), verTopoPilha(&pilha));
-                break;
-            }
-                
-            case 7: {
-                // Visualizar histórico
-                visualizarHistorico(&historico);
-                break;
-            }
-                
-            case 0:
-                printf("\n👋 Obrigado por jogar Tetris Mestre!\n");
-                break;
-                
-            default:
-                printf("\n❌ Opção inválida!\n");
-                break;
+        mostrarMenu(usarVersoes);
+        fflush(stdout);
+        
+        // Fim da entrada: encerra como se a opção 0 fosse escolhida. Texto que
+        // não é número é descartado até o fim da linha, sem executar nada.
+        int lidos = scanf("%d", &opcao);
+        if (lidos == EOF) break;
+        if (lidos != 1) {
+            int c = getchar();
+            while (c != '\n' && c != EOF) c = getchar();
+            opcao = OPCAO_ENTRADA_INVALIDA;
+            continue;
         }
         
+        atenderPedidoMetricas(&estado);
+        
+        temResultado = opcao != ACAO_VISUALIZAR_HISTORICO && opcao != OPCAO_METRICAS;
+        if (usarVersoes && opcao == ACAO_DESFAZER) {
+            navegou = desfazerVersao(&versoes);
+            temResultado = 0;
+        } else if (usarVersoes && opcao == OPCAO_REFAZER) {
+            navegou = refazerVersao(&versoes);
+            temResultado = 0;
+        } else if (usarVersoes && opcao == OPCAO_TROCAR_RAMO) {
+            navegou = trocarRamoVersao(&versoes);
+            temResultado = 0;
+        }
+        if (temResultado) {
+            resultado = executarAcao(&estado, (AcaoJogo) opcao);
+        }
+        atenderSalvamento(&estado);
+        
     } while (opcao != 0);
     
+    mostrarResultado(&estado, ACAO_SAIR, RESULTADO_OK);
+    if (arquivoMetricas != NULL) despejarMetricas(&estado);
+    encerrarGravacao(&gravador, arquivoGravacao);
+    encerrarSalvamentoAutomatico(&estado, arquivoSalvamento);
+    liberarArvoreVersoes(&versoes);
+    liberarJogo(&estado);
     return 0;
-}
\ No newline at end of file
+}
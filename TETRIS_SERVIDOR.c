@@ -0,0 +1,661 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "metricas.h"
+#include "motor.h"
+#include "relogio.h"
+
+// Servidor de partidas do Tetris - Nível Mestre
+// Hospeda muitas partidas independentes num único processo, com um laço de
+// eventos epoll sobre um socket Unix ou TCP na interface local. Todas as
+// sessões (estado do jogo e buffers) e os seus históricos saem de dois pools
+// de blocos (ver arena.h) numa única arena reservada na partida do servidor;
+// conectar e desconectar só pegam e devolvem blocos, sem malloc.
+//
+// Protocolo em linhas de texto. Ao conectar, o servidor envia
+//   ola <sessao> <semente>
+// e depois responde a cada linha com um número de ação (as opções do menu,
+// 1 a 11) com uma linha
+//   <resultado> <fila> <pilha> <linhas removidas> <tamanho do histórico>
+// onde <resultado> é o código de ResultadoAcao (0 = ok) e fila e pilha são as
+// letras das peças (a pilha da base para o topo; "-" quando vazia). A linha
+// "0" encerra a sessão. Vários comandos podem ser enviados sem esperar as
+// respostas, que chegam na mesma ordem.
+//
+// Uso:
+//   TETRIS_SERVIDOR [--unix CAMINHO | --porta N] [--sessoes N] [--historico N] [--semente N] [--metricas]
+//   TETRIS_SERVIDOR --carga [--unix CAMINHO | --porta N] [--sessoes N] [--comandos N] [--janela N]
+// O modo --carga é um cliente de teste: abre várias sessões ao mesmo tempo,
+// envia ações aleatórias e mede a vazão. Com --metricas o servidor mede a
+// latência de cada ação no motor (somando todas as sessões) e mostra a
+// tabela ao receber SIGUSR1 e ao encerrar.
+
+#define PORTA_PADRAO 7420
+#define SESSOES_PADRAO 4096
+#define COMANDOS_CARGA_PADRAO 1000
+#define JANELA_CARGA_PADRAO 16
+#define MAX_EVENTOS 256
+
+#define TAMANHO_ENTRADA 512
+#define TAMANHO_SAIDA 2048
+
+// Espaço de uma resposta: a fila e a pilha com no máximo 8 peças, e números
+#define MAX_RESPOSTA 96
+
+// Valor de epoll_data que identifica o socket de escuta
+#define EVENTO_ESCUTA UINT32_MAX
+
+typedef struct {
+    int descritor;              // -1 quando a posição está livre
+    EstadoJogo estado;
+    size_t usadoEntrada;
+    size_t inicioSaida;         // primeiro byte ainda não enviado
+    size_t usadoSaida;
+    int esperandoEscrita;       // inscrito em EPOLLOUT com saída pendente
+    char entrada[TAMANHO_ENTRADA];
+    char saida[TAMANHO_SAIDA];
+} Sessao;
+
+// Endereço onde o servidor escuta (ou o cliente de carga conecta)
+typedef struct {
+    const char *caminhoUnix;    // NULL para TCP em 127.0.0.1
+    int porta;
+} Endereco;
+
+typedef struct {
+    Arena memoria;
+    PoolBlocos sessoes;
+    PoolBlocos historicos;      // um bloco de registros por sessão aberta
+    size_t capacidadeHistorico;
+    int ativas;
+    int epoll;
+    int escuta;
+    ConfiguracaoJogo configuracao;
+    MetricasJogo *metricas;     // NULL sem --metricas
+    unsigned long conexoes;
+    unsigned long comandos;
+} Servidor;
+
+static volatile sig_atomic_t interrompido = 0;
+static volatile sig_atomic_t pedidoMetricas = 0;
+
+void tratarInterrupcao(int sinal) {
+    (void) sinal;
+    interrompido = 1;
+}
+
+void tratarPedidoMetricas(int sinal) {
+    (void) sinal;
+    pedidoMetricas = 1;
+}
+
+static int tornarNaoBloqueante(int descritor) {
+    int flags = fcntl(descritor, F_GETFL, 0);
+    return flags >= 0 && fcntl(descritor, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Funções do bloco de sessões
+// Função para reservar numa só arena as sessões e os históricos
+// Retorna 1 em caso de sucesso e 0 se não houver memória (ou se o total não
+// couber num size_t).
+int criarSessoes(Servidor *servidor, int capacidade, size_t capacidadeHistorico) {
+    if (capacidade < 1) return 0;
+    if (capacidadeHistorico == 0) capacidadeHistorico = 1;
+
+    // Folga de uma linha de cache por pool para o alinhamento
+    size_t porSessao = sizeof(Sessao) + 64 + 64 + 2 * sizeof(int);
+    size_t maximoPorSessao = (SIZE_MAX - 2 * 64) / (size_t) capacidade;
+    if (maximoPorSessao < porSessao || capacidadeHistorico > (maximoPorSessao - porSessao) / sizeof(RegistroHistorico)) {
+        return 0;
+    }
+    size_t bytesHistorico = capacidadeHistorico * sizeof(RegistroHistorico);
+    size_t bytes = (size_t) capacidade * (porSessao + bytesHistorico) + 2 * 64;
+    if (!criarArena(&servidor->memoria, bytes)) return 0;
+    if (!criarPoolArena(&servidor->sessoes, &servidor->memoria, sizeof(Sessao), 64, capacidade) ||
+        !criarPoolArena(&servidor->historicos, &servidor->memoria, bytesHistorico, 64, capacidade)) {
+        liberarArena(&servidor->memoria);
+        return 0;
+    }
+
+    servidor->capacidadeHistorico = capacidadeHistorico;
+    for (int i = 0; i < capacidade; i++) {
+        Sessao *sessao = blocoPool(&servidor->sessoes, i);
+        sessao->descritor = -1;
+    }
+    servidor->ativas = 0;
+    return 1;
+}
+
+static Sessao *sessaoPorIndice(Servidor *servidor, int indice) {
+    return blocoPool(&servidor->sessoes, indice);
+}
+
+// Pega uma sessão e um histórico livres e começa uma partida; retorna -1 se
+// estiver tudo ocupado
+static int abrirSessao(Servidor *servidor, int descritor) {
+    Sessao *sessao = alocarPool(&servidor->sessoes);
+    if (sessao == NULL) return -1;
+
+    // Os dois pools têm a mesma capacidade, então sempre há um histórico livre
+    int indice = indicePool(&servidor->sessoes, sessao);
+    sessao->estado.historico.registros = alocarPool(&servidor->historicos);
+    sessao->estado.historico.capacidade = servidor->capacidadeHistorico;
+    servidor->ativas++;
+
+    // Cada sessão recebe uma semente diferente, derivada da semente do servidor
+    ConfiguracaoJogo configuracao = servidor->configuracao;
+    configuracao.semente += servidor->conexoes++;
+    reiniciarJogo(&sessao->estado, &configuracao);
+    sessao->estado.metricas = servidor->metricas;
+
+    sessao->descritor = descritor;
+    sessao->usadoEntrada = 0;
+    sessao->inicioSaida = 0;
+    sessao->usadoSaida = (size_t) snprintf(sessao->saida, TAMANHO_SAIDA, "ola %d %llu\n", indice,
+                                           (unsigned long long) configuracao.semente);
+    sessao->esperandoEscrita = 0;
+    return indice;
+}
+
+static void fecharSessao(Servidor *servidor, int indice) {
+    Sessao *sessao = sessaoPorIndice(servidor, indice);
+    epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, sessao->descritor, NULL);
+    close(sessao->descritor);
+    sessao->descritor = -1;
+    devolverPool(&servidor->historicos, sessao->estado.historico.registros);
+    devolverPool(&servidor->sessoes, sessao);
+    servidor->ativas--;
+}
+
+// Funções do protocolo
+static char *escreverNumero(char *destino, unsigned long valor) {
+    char digitos[24];
+    int n = 0;
+    do {
+        digitos[n++] = (char) ('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    while (n > 0) *destino++ = digitos[--n];
+    return destino;
+}
+
+// Escreve a resposta de um comando na saída da sessão
+static void responder(Sessao *sessao, ResultadoAcao resultado) {
+    EstadoJogo *estado = &sessao->estado;
+    char *destino = sessao->saida + sessao->usadoSaida;
+
+    destino = escreverNumero(destino, (unsigned long) resultado);
+    *destino++ = ' ';
+    for (int i = 0; i < estado->fila.quantidade; i++) *destino++ = letraPeca(*posicaoFila(&estado->fila, i));
+    if (filaVazia(&estado->fila)) *destino++ = '-';
+    *destino++ = ' ';
+    for (int i = 0; i < estado->pilha.quantidade; i++) *destino++ = letraPeca(estado->pilha.pecas[i]);
+    if (pilhaVazia(&estado->pilha)) *destino++ = '-';
+    *destino++ = ' ';
+    destino = escreverNumero(destino, (unsigned long) estado->linhasRemovidas);
+    *destino++ = ' ';
+    destino = escreverNumero(destino, (unsigned long) estado->historico.quantidade);
+    *destino++ = '\n';
+
+    sessao->usadoSaida = (size_t) (destino - sessao->saida);
+}
+
+// Interpreta uma linha; retorna 0 se a sessão pediu para sair
+static int executarLinha(Servidor *servidor, Sessao *sessao, const char *linha, size_t tamanho) {
+    int acao = 0;
+    size_t i = 0;
+    while (i < tamanho && (linha[i] == ' ' || linha[i] == '\r')) i++;
+    if (i == tamanho) return 1;     // linha em branco
+
+    int valida = 0;
+    while (i < tamanho && linha[i] >= '0' && linha[i] <= '9' && acao < TOTAL_ACOES) {
+        acao = acao * 10 + (linha[i++] - '0');
+        valida = 1;
+    }
+    while (i < tamanho && (linha[i] == ' ' || linha[i] == '\r')) i++;
+    if (i != tamanho || acao >= TOTAL_ACOES) valida = 0;
+
+    if (valida && acao == ACAO_SAIR) return 0;
+
+    servidor->comandos++;
+    if (!valida && servidor->metricas != NULL) servidor->metricas->acoesDesconhecidas++;
+    responder(sessao, valida ? executarAcao(&sessao->estado, (AcaoJogo) acao) : RESULTADO_ACAO_INVALIDA);
+    return 1;
+}
+
+// Envia o que der da saída pendente; retorna 0 se a conexão caiu
+static int enviarSaida(Servidor *servidor, int indice) {
+    Sessao *sessao = sessaoPorIndice(servidor, indice);
+
+    while (sessao->inicioSaida < sessao->usadoSaida) {
+        ssize_t enviados = send(sessao->descritor, sessao->saida + sessao->inicioSaida,
+                                sessao->usadoSaida - sessao->inicioSaida, MSG_NOSIGNAL);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return 0;
+        }
+        sessao->inicioSaida += (size_t) enviados;
+    }
+
+    int pendente = sessao->inicioSaida < sessao->usadoSaida;
+    if (!pendente) sessao->inicioSaida = sessao->usadoSaida = 0;
+
+    // Com saída pendente, espera o socket liberar espaço e para de ler a
+    // entrada até lá (o cliente que não lê as respostas não enche a memória)
+    if (pendente != sessao->esperandoEscrita) {
+        struct epoll_event evento = {.events = pendente ? EPOLLOUT : EPOLLIN, .data.u32 = (uint32_t) indice};
+        epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, sessao->descritor, &evento);
+        sessao->esperandoEscrita = pendente;
+    }
+    return 1;
+}
+
+static int temLinhaCompleta(const Sessao *sessao) {
+    return memchr(sessao->entrada, '\n', sessao->usadoEntrada) != NULL;
+}
+
+// Executa as linhas completas da entrada, enquanto houver espaço para as respostas
+// Retorna 0 se a sessão terminou.
+static int processarEntrada(Servidor *servidor, Sessao *sessao) {
+    size_t consumidos = 0;
+
+    while (consumidos < sessao->usadoEntrada && sessao->usadoSaida + MAX_RESPOSTA <= TAMANHO_SAIDA) {
+        char *inicio = sessao->entrada + consumidos;
+        char *fim = memchr(inicio, '\n', sessao->usadoEntrada - consumidos);
+        if (fim == NULL) break;
+
+        if (!executarLinha(servidor, sessao, inicio, (size_t) (fim - inicio))) return 0;
+        consumidos += (size_t) (fim - inicio) + 1;
+    }
+
+    sessao->usadoEntrada -= consumidos;
+    memmove(sessao->entrada, sessao->entrada + consumidos, sessao->usadoEntrada);
+
+    // Uma linha maior que o buffer inteiro não é um comando válido
+    return sessao->usadoEntrada < TAMANHO_ENTRADA || temLinhaCompleta(sessao);
+}
+
+// Atende as linhas completas e envia as respostas, até acabarem as linhas ou
+// o socket não aceitar mais dados. Retorna 0 se a sessão terminou.
+static int atenderSessao(Servidor *servidor, int indice) {
+    Sessao *sessao = sessaoPorIndice(servidor, indice);
+    do {
+        if (!processarEntrada(servidor, sessao)) {
+            // Pedido de saída: as respostas anteriores ainda vão, se couberem no socket
+            enviarSaida(servidor, indice);
+            return 0;
+        }
+        if (!enviarSaida(servidor, indice)) return 0;
+    } while (!sessao->esperandoEscrita && temLinhaCompleta(sessao));
+    return 1;
+}
+
+static void tratarSessao(Servidor *servidor, int indice, uint32_t eventos) {
+    Sessao *sessao = sessaoPorIndice(servidor, indice);
+
+    if (eventos & (EPOLLHUP | EPOLLERR)) {
+        fecharSessao(servidor, indice);
+        return;
+    }
+
+    if (eventos & EPOLLOUT) {
+        // Ao liberar a saída, atende as linhas que ficaram esperando
+        if (!enviarSaida(servidor, indice) || !atenderSessao(servidor, indice)) fecharSessao(servidor, indice);
+        return;
+    }
+
+    for (;;) {
+        ssize_t lidos = recv(sessao->descritor, sessao->entrada + sessao->usadoEntrada,
+                             TAMANHO_ENTRADA - sessao->usadoEntrada, 0);
+        if (lidos == 0) {
+            fecharSessao(servidor, indice);
+            return;
+        }
+        if (lidos < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            fecharSessao(servidor, indice);
+            return;
+        }
+        sessao->usadoEntrada += (size_t) lidos;
+
+        if (!atenderSessao(servidor, indice)) {
+            fecharSessao(servidor, indice);
+            return;
+        }
+        if (sessao->esperandoEscrita) break;
+    }
+}
+
+static void aceitarConexoes(Servidor *servidor) {
+    for (;;) {
+        int descritor = accept4(servidor->escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descritor < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept4");
+            return;
+        }
+
+        int indice = abrirSessao(servidor, descritor);
+        if (indice < 0) {
+            // Sem posição livre: recusa fechando a conexão
+            close(descritor);
+            continue;
+        }
+
+        int sim = 1;
+        setsockopt(descritor, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim));
+        struct epoll_event evento = {.events = EPOLLIN, .data.u32 = (uint32_t) indice};
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, descritor, &evento) != 0 || !enviarSaida(servidor, indice)) {
+            fecharSessao(servidor, indice);
+        }
+    }
+}
+
+// Cria o socket de escuta (ou, com "conectar", o socket de um cliente)
+// Retorna o descritor ou -1 em caso de erro.
+static int abrirSocket(const Endereco *endereco, int conectar) {
+    struct sockaddr_un enderecoUnix;
+    struct sockaddr_in enderecoTcp;
+    struct sockaddr *destino;
+    socklen_t tamanho;
+    int familia;
+
+    if (endereco->caminhoUnix != NULL) {
+        memset(&enderecoUnix, 0, sizeof(enderecoUnix));
+        enderecoUnix.sun_family = AF_UNIX;
+        if (strlen(endereco->caminhoUnix) >= sizeof(enderecoUnix.sun_path)) return -1;
+        strcpy(enderecoUnix.sun_path, endereco->caminhoUnix);
+        destino = (struct sockaddr *) &enderecoUnix;
+        tamanho = sizeof(enderecoUnix);
+        familia = AF_UNIX;
+    } else {
+        memset(&enderecoTcp, 0, sizeof(enderecoTcp));
+        enderecoTcp.sin_family = AF_INET;
+        enderecoTcp.sin_port = htons((uint16_t) endereco->porta);
+        enderecoTcp.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        destino = (struct sockaddr *) &enderecoTcp;
+        tamanho = sizeof(enderecoTcp);
+        familia = AF_INET;
+    }
+
+    int descritor = socket(familia, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descritor < 0) return -1;
+
+    if (conectar) {
+        if (connect(descritor, destino, tamanho) != 0) {
+            close(descritor);
+            return -1;
+        }
+        if (familia == AF_INET) {
+            int sim = 1;
+            setsockopt(descritor, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim));
+        }
+        return descritor;
+    }
+
+    int sim = 1;
+    setsockopt(descritor, SOL_SOCKET, SO_REUSEADDR, &sim, sizeof(sim));
+    if (familia == AF_UNIX) unlink(endereco->caminhoUnix);
+    if (bind(descritor, destino, tamanho) != 0 || listen(descritor, SOMAXCONN) != 0 || !tornarNaoBloqueante(descritor)) {
+        close(descritor);
+        return -1;
+    }
+    return descritor;
+}
+
+// Laço principal do servidor: roda até receber SIGINT/SIGTERM
+int executarServidor(const Endereco *endereco, int capacidade, const ConfiguracaoJogo *configuracao, int medir) {
+    static Servidor servidor;
+    static MetricasJogo metricas;
+    servidor.configuracao = *configuracao;
+    servidor.metricas = medir ? &metricas : NULL;
+    inicializarMetricas(&metricas);
+
+    if (!criarSessoes(&servidor, capacidade, configuracao->capacidadeHistorico)) {
+        fprintf(stderr, "Erro: memória insuficiente para %d sessões!\n", capacidade);
+        return 1;
+    }
+
+    servidor.escuta = abrirSocket(endereco, 0);
+    servidor.epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event evento = {.events = EPOLLIN, .data.u32 = EVENTO_ESCUTA};
+    if (servidor.escuta < 0 || servidor.epoll < 0 || epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, servidor.escuta, &evento) != 0) {
+        perror("Erro ao abrir o servidor");
+        return 1;
+    }
+
+    signal(SIGINT, tratarInterrupcao);
+    signal(SIGTERM, tratarInterrupcao);
+    signal(SIGPIPE, SIG_IGN);
+    if (medir) signal(SIGUSR1, tratarPedidoMetricas);
+
+    if (endereco->caminhoUnix != NULL) {
+        printf("🖥️  Servidor ouvindo em %s", endereco->caminhoUnix);
+    } else {
+        printf("🖥️  Servidor ouvindo em 127.0.0.1:%d", endereco->porta);
+    }
+    printf(" (até %d sessões, %.1f KB por sessão)\n", capacidade,
+           (sizeof(Sessao) + servidor.capacidadeHistorico * sizeof(RegistroHistorico)) / 1024.0);
+    fflush(stdout);
+
+    int64_t inicio = relogioNs();
+    long alocacoesAntes = alocacoesProcesso();
+    struct epoll_event eventos[MAX_EVENTOS];
+    while (!interrompido) {
+        int quantidade = epoll_wait(servidor.epoll, eventos, MAX_EVENTOS, 1000);
+        for (int i = 0; i < quantidade; i++) {
+            if (eventos[i].data.u32 == EVENTO_ESCUTA) {
+                aceitarConexoes(&servidor);
+            } else {
+                tratarSessao(&servidor, (int) eventos[i].data.u32, eventos[i].events);
+            }
+        }
+        if (pedidoMetricas) {
+            pedidoMetricas = 0;
+            mostrarMetricas(&metricas, stdout);
+            fflush(stdout);
+        }
+    }
+    double segundos = (relogioNs() - inicio) / 1e9;
+    long alocacoes = alocacoesProcesso() - alocacoesAntes;
+
+    printf("\n=== SERVIDOR ENCERRADO ===\n");
+    printf("Conexões atendidas: %lu (%d ainda abertas)\n", servidor.conexoes, servidor.ativas);
+    printf("Comandos: %lu em %.1f s (%.0f por segundo)\n", servidor.comandos, segundos,
+           segundos > 0 ? servidor.comandos / segundos : 0.0);
+    if (alocacoesAntes >= 0) printf("Alocações durante o atendimento: %ld\n", alocacoes);
+    if (medir) mostrarMetricas(&metricas, stdout);
+
+    for (int i = 0; i < servidor.sessoes.capacidade; i++) {
+        Sessao *sessao = sessaoPorIndice(&servidor, i);
+        if (sessao->descritor >= 0) close(sessao->descritor);
+    }
+    close(servidor.escuta);
+    close(servidor.epoll);
+    if (endereco->caminhoUnix != NULL) unlink(endereco->caminhoUnix);
+    liberarArena(&servidor.memoria);
+    return 0;
+}
+
+// Funções do cliente de carga
+typedef struct {
+    int descritor;
+    long enviados;
+    long respondidos;
+    int saudado;            // já recebeu a linha "ola"
+} ConexaoCarga;
+
+// Envia a próxima janela de comandos de uma conexão
+static int enviarJanela(ConexaoCarga *conexao, GeradorPecas *sorteio, long comandos, int janela) {
+    char buffer[JANELA_CARGA_PADRAO * 4 * 8];
+    size_t tamanho = 0;
+    long limite = conexao->respondidos + janela < comandos ? conexao->respondidos + janela : comandos;
+
+    while (conexao->enviados < limite && tamanho + 4 <= sizeof(buffer)) {
+        int acao = (int) aleatorioAte(sorteio, TOTAL_ACOES - 1) + 1;
+        if (acao == ACAO_VISUALIZAR_HISTORICO) acao = ACAO_JOGAR;
+        if (acao >= 10) buffer[tamanho++] = '1';
+        buffer[tamanho++] = (char) ('0' + acao % 10);
+        buffer[tamanho++] = '\n';
+        conexao->enviados++;
+    }
+
+    return send(conexao->descritor, buffer, tamanho, MSG_NOSIGNAL) == (ssize_t) tamanho;
+}
+
+// Laço do cliente de carga: cada conexão manda uma janela de comandos e só
+// manda a próxima quando todas foram respondidas
+// Retorna quantos comandos foram respondidos, ou -1 em caso de erro.
+static long conduzirCarga(ConexaoCarga *conexoes, int epoll, int sessoes, long comandos, int janela) {
+    GeradorPecas sorteio;
+    inicializarGerador(&sorteio, 1, GERADOR_UNIFORME);
+
+    int pendentes = sessoes;
+    long totalRespondidos = 0;
+    char buffer[1 << 16];
+    struct epoll_event eventos[MAX_EVENTOS];
+    while (pendentes > 0) {
+        int quantidade = epoll_wait(epoll, eventos, MAX_EVENTOS, 5000);
+        if (quantidade <= 0) {
+            fprintf(stderr, "Erro: o servidor parou de responder (%d sessões pendentes)\n", pendentes);
+            return -1;
+        }
+
+        for (int e = 0; e < quantidade; e++) {
+            ConexaoCarga *conexao = &conexoes[eventos[e].data.u32];
+            ssize_t lidos = recv(conexao->descritor, buffer, sizeof(buffer), 0);
+            if (lidos <= 0) {
+                fprintf(stderr, "Erro: o servidor fechou uma sessão antes do fim\n");
+                return -1;
+            }
+
+            for (ssize_t k = 0; k < lidos; k++) {
+                if (buffer[k] != '\n') continue;
+                if (!conexao->saudado) {
+                    conexao->saudado = 1;
+                } else {
+                    conexao->respondidos++;
+                    totalRespondidos++;
+                }
+            }
+
+            if (conexao->saudado && conexao->respondidos == conexao->enviados) {
+                if (conexao->respondidos == comandos) {
+                    send(conexao->descritor, "0\n", 2, MSG_NOSIGNAL);
+                    epoll_ctl(epoll, EPOLL_CTL_DEL, conexao->descritor, NULL);
+                    close(conexao->descritor);
+                    conexao->descritor = -1;
+                    pendentes--;
+                } else if (!enviarJanela(conexao, &sorteio, comandos, janela)) {
+                    fprintf(stderr, "Erro ao enviar comandos\n");
+                    return -1;
+                }
+            }
+        }
+    }
+    return totalRespondidos;
+}
+
+int executarCarga(const Endereco *endereco, int sessoes, long comandos, int janela) {
+    ConexaoCarga *conexoes = calloc((size_t) sessoes, sizeof(ConexaoCarga));
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (conexoes == NULL || epoll < 0) {
+        fprintf(stderr, "Erro: memória insuficiente!\n");
+        free(conexoes);
+        return 1;
+    }
+    if (janela < 1) janela = 1;
+    if (janela > JANELA_CARGA_PADRAO * 8) janela = JANELA_CARGA_PADRAO * 8;
+    signal(SIGPIPE, SIG_IGN);
+
+    int64_t inicio = relogioNs();
+    int conectadas = 0;
+    for (; conectadas < sessoes; conectadas++) {
+        ConexaoCarga *conexao = &conexoes[conectadas];
+        conexao->descritor = abrirSocket(endereco, 1);
+        if (conexao->descritor < 0) {
+            fprintf(stderr, "Erro ao conectar a sessão %d: %s\n", conectadas, strerror(errno));
+            break;
+        }
+        struct epoll_event evento = {.events = EPOLLIN, .data.u32 = (uint32_t) conectadas};
+        epoll_ctl(epoll, EPOLL_CTL_ADD, conexao->descritor, &evento);
+    }
+    int64_t conectado = relogioNs();
+
+    long respondidos = conectadas == sessoes ? conduzirCarga(conexoes, epoll, sessoes, comandos, janela) : -1;
+    double segundos = (relogioNs() - conectado) / 1e9;
+
+    if (respondidos >= 0) {
+        printf("=== CARGA CONCLUÍDA ===\n");
+        printf("Sessões: %d (conectadas em %.1f ms)\n", sessoes, (conectado - inicio) / 1e6);
+        printf("Comandos respondidos: %ld em %.3f s\n", respondidos, segundos);
+        printf("Vazão: %.0f comandos/s (janela de %d comandos por sessão)\n",
+               segundos > 0 ? respondidos / segundos : 0.0, janela);
+    }
+
+    for (int i = 0; i < conectadas; i++) {
+        if (conexoes[i].descritor >= 0) close(conexoes[i].descritor);
+    }
+    close(epoll);
+    free(conexoes);
+    return respondidos < 0;
+}
+
+int main(int argc, char *argv[]) {
+    Endereco endereco = {NULL, PORTA_PADRAO};
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
+    int sessoes = SESSOES_PADRAO;
+    int carga = 0;
+    int sessoesDefinidas = 0;
+    long comandos = COMANDOS_CARGA_PADRAO;
+    int janela = JANELA_CARGA_PADRAO;
+    int medir = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            endereco.caminhoUnix = argv[++i];
+        } else if (strcmp(argv[i], "--porta") == 0 && i + 1 < argc) {
+            endereco.porta = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sessoes") == 0 && i + 1 < argc) {
+            sessoes = atoi(argv[++i]);
+            sessoesDefinidas = 1;
+        } else if (strcmp(argv[i], "--historico") == 0 && i + 1 < argc) {
+            configuracao.capacidadeHistorico = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            configuracao.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--metricas") == 0) {
+            medir = 1;
+        } else if (strcmp(argv[i], "--carga") == 0) {
+            carga = 1;
+        } else if (strcmp(argv[i], "--comandos") == 0 && i + 1 < argc) {
+            comandos = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--janela") == 0 && i + 1 < argc) {
+            janela = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Uso: %s [--unix CAMINHO | --porta N] [--sessoes N] [--historico N] [--semente N] [--metricas]\n",
+                    argv[0]);
+            fprintf(stderr, "     %s --carga [--unix CAMINHO | --porta N] [--sessoes N] [--comandos N] [--janela N]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (sessoes < 1) sessoes = 1;
+
+    if (carga) return executarCarga(&endereco, sessoesDefinidas ? sessoes : 100, comandos, janela);
+    return executarServidor(&endereco, sessoes, &configuracao, medir);
+}
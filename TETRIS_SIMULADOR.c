@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "estatisticas.h"
+#include "gravacao.h"
+#include "motor.h"
+#include "relogio.h"
+
+// Simulador em lote do Tetris - Nível Mestre
+// Reproduz uma sequência binária de ações (um byte por ação, com os mesmos
+// valores do menu) diretamente no motor, sem nenhuma saída durante a execução.
+// Também reproduz partidas gravadas (ver gravacao.h) e converte sequências
+// de ações para esse formato.
+//
+// Uso:
+//   TETRIS_SIMULADOR <arquivo> [repeticoes] [semente] [historico] [assincrono]
+//   TETRIS_SIMULADOR --gerar <arquivo> <quantidade> [semente]
+//   TETRIS_SIMULADOR --reproduzir <gravacao> [repeticoes]
+//   TETRIS_SIMULADOR --converter <arquivo> <gravacao> [semente] [historico]
+//   TETRIS_SIMULADOR --estatisticas <quantidade> [semente] [saco|uniforme] [escalar|ssse3|avx2]
+
+// Função para gerar um arquivo com ações aleatórias (de 1 a TOTAL_ACOES - 1)
+int gerarArquivoAcoes(const char *caminho, long quantidade, uint64_t semente) {
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        perror(caminho);
+        return 1;
+    }
+
+    GeradorPecas sorteio;
+    inicializarGerador(&sorteio, semente, GERADOR_UNIFORME);
+    for (long i = 0; i < quantidade; i++) {
+        fputc(aleatorioAte(&sorteio, TOTAL_ACOES - 1) + 1, arquivo);
+    }
+
+    fclose(arquivo);
+    printf("📝 %ld ações gravadas em %s\n", quantidade, caminho);
+    return 0;
+}
+
+// Função para carregar o arquivo de ações inteiro na memória
+unsigned char *carregarArquivoAcoes(const char *caminho, size_t *tamanho) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        perror(caminho);
+        return NULL;
+    }
+
+    fseek(arquivo, 0, SEEK_END);
+    long bytes = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+
+    unsigned char *acoes = malloc(bytes > 0 ? bytes : 1);
+    if (acoes == NULL || fread(acoes, 1, bytes, arquivo) != (size_t) bytes) {
+        fprintf(stderr, "Erro ao ler %s\n", caminho);
+        free(acoes);
+        fclose(arquivo);
+        return NULL;
+    }
+
+    fclose(arquivo);
+    *tamanho = bytes;
+    return acoes;
+}
+
+// Resumo do estado final, comum à simulação e à reprodução. A assinatura do
+// tabuleiro (FNV-1a das linhas) permite comparar rapidamente duas execuções.
+void mostrarEstadoFinal(EstadoJogo *estado) {
+    uint64_t assinatura = 0xcbf29ce484222325ULL;
+    for (int r = 0; r < estado->tabuleiro.altura; r++) {
+        assinatura = (assinatura ^ estado->tabuleiro.linhas[r]) * 0x100000001b3ULL;
+    }
+
+    printf("Estado final - Fila: %d peças, Pilha: %d peças, Frente: '%c', Topo: '%c'\n",
+           estado->fila.quantidade, estado->pilha.quantidade,
+           letraPeca(verFrenteFila(&estado->fila)), letraPeca(verTopoPilha(&estado->pilha)));
+    printf("Linhas removidas: %ld\n", estado->linhasRemovidas);
+    printf("Tabuleiro: %016llx\n", (unsigned long long) assinatura);
+    printf("Histórico: %zu/%zu ações\n", estado->historico.quantidade, estado->historico.capacidade);
+}
+
+// Resumo das estatísticas de uma sequência de peças
+void mostrarEstatisticasPecas(const EstatisticasPecas *estatisticas) {
+    printf("Frequência:");
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+        Peca peca = {t, 0};
+        printf(" %c %.3f%%", letraPeca(peca),
+               estatisticas->total > 0 ? 100.0 * estatisticas->contagem[t] / estatisticas->total : 0.0);
+    }
+    printf("\n");
+    if (estatisticas->contagem[TOTAL_TIPOS_PECA] > 0) {
+        printf("⚠️  Tipos inválidos: %llu\n", (unsigned long long) estatisticas->contagem[TOTAL_TIPOS_PECA]);
+    }
+    printf("Qui-quadrado (6 g.l.): %.2f\n", quiQuadradoPecas(estatisticas));
+    printf("Maior seca de I: %llu peças | Secas acima de %d: %llu\n", (unsigned long long) estatisticas->maiorSeca,
+           LIMITE_SECA_SACO, (unsigned long long) estatisticas->secasLongas);
+    printf("Sacos de 7 irregulares: %llu de %llu\n", (unsigned long long) estatisticas->sacosIrregulares,
+           (unsigned long long) estatisticas->sacos);
+}
+
+// Função para auditar a sequência de peças do gerador
+// As estatísticas são calculadas em lotes à medida que as peças são geradas;
+// o tempo das duas etapas é medido em separado.
+int auditarGerador(uint64_t quantidade, uint64_t semente, ModoGerador modo) {
+    static unsigned char lote[1 << 16];
+    GeradorPecas gerador;
+    EstatisticasPecas estatisticas;
+    inicializarGerador(&gerador, semente, modo);
+    inicializarEstatisticasPecas(&estatisticas);
+
+    double tempoGeracao = 0, tempoEstatisticas = 0;
+    for (uint64_t restantes = quantidade; restantes > 0;) {
+        size_t tamanho = restantes < sizeof(lote) ? (size_t) restantes : sizeof(lote);
+        double inicio = relogioNs() / 1e9;
+        gerarLoteTipos(&gerador, lote, tamanho);
+        double meio = relogioNs() / 1e9;
+        acumularTipos(&estatisticas, lote, tamanho);
+        tempoGeracao += meio - inicio;
+        tempoEstatisticas += relogioNs() / 1e9 - meio;
+        restantes -= tamanho;
+    }
+
+    printf("=== AUDITORIA DO GERADOR ===\n");
+    printf("Peças: %llu, semente %llu, modo %s\n", (unsigned long long) quantidade, (unsigned long long) semente,
+           modo == GERADOR_SACO ? "saco" : "uniforme");
+    mostrarEstatisticasPecas(&estatisticas);
+    printf("Geração: %.3f s | Estatísticas (%s): %.3f s, %.2f GB/s\n", tempoGeracao,
+           nomeNivelSimd(nivelSimdEstatisticas()), tempoEstatisticas,
+           tempoEstatisticas > 0 ? quantidade / tempoEstatisticas / 1e9 : 0.0);
+    return 0;
+}
+
+// Observador da conversão: grava sem intervalo entre as ações
+void gravarSemIntervalo(void *contexto, AcaoJogo acao) {
+    GravadorPartida *gravador = contexto;
+    gravarAcao(gravador, acao, gravador->inicioNs);
+}
+
+// Função para converter uma sequência de ações em gravação de partida
+// Só as ações aceitas pelo motor são gravadas, já que as rejeitadas não
+// mudam o estado.
+int converterArquivoAcoes(const char *origem, const char *destino, uint64_t semente, size_t capacidadeHistorico) {
+    static GravadorPartida gravador;
+    size_t quantidade;
+    unsigned char *acoes = carregarArquivoAcoes(origem, &quantidade);
+    if (acoes == NULL) return 1;
+
+    EstadoJogo estado;
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
+    configuracao.capacidadeHistorico = capacidadeHistorico;
+    configuracao.semente = semente;
+    if (!inicializarJogo(&estado, &configuracao)) {
+        fprintf(stderr, "Erro: memória insuficiente para o histórico!\n");
+        free(acoes);
+        return 1;
+    }
+    if (!abrirGravacao(&gravador, destino, &configuracao)) {
+        perror(destino);
+        liberarJogo(&estado);
+        free(acoes);
+        return 1;
+    }
+
+    estado.observador = gravarSemIntervalo;
+    estado.contextoObservador = &gravador;
+    executarAcoes(&estado, acoes, quantidade);
+
+    long gravadas = gravador.acoes;
+    int sucesso = fecharGravacao(&gravador);
+    liberarJogo(&estado);
+    free(acoes);
+
+    if (!sucesso) {
+        fprintf(stderr, "Erro ao gravar %s\n", destino);
+        return 1;
+    }
+    printf("📝 %ld de %zu ações gravadas em %s\n", gravadas, quantidade, destino);
+    return 0;
+}
+
+// Função para reproduzir uma gravação no motor, o mais rápido possível
+int reproduzirArquivoGravacao(const char *caminho, int repeticoes) {
+    LeitorPartida leitor;
+    if (!abrirLeitura(&leitor, caminho)) {
+        fprintf(stderr, "Erro: %s não é uma gravação válida\n", caminho);
+        return 1;
+    }
+
+    // Cada repetição refaz a partida do começo, com a configuração gravada
+    EstadoJogo estado;
+    double duracao = 0;
+    size_t total = 0;
+    for (int r = 0; r < repeticoes; r++) {
+        if (!inicializarJogo(&estado, &leitor.configuracao)) {
+            fprintf(stderr, "Erro: memória insuficiente para o histórico!\n");
+            fecharLeitura(&leitor);
+            return 1;
+        }
+
+        leitor.posicao = GRAVACAO_TAMANHO_CABECALHO;
+        leitor.instanteUs = 0;
+        double inicio = relogioNs() / 1e9;
+        total += reproduzirPartida(&leitor, &estado);
+        duracao += relogioNs() / 1e9 - inicio;
+
+        if (r + 1 < repeticoes) liberarJogo(&estado);
+    }
+
+    printf("=== REPRODUÇÃO CONCLUÍDA ===\n");
+    printf("Gravação: %zu bytes, semente %llu, tabuleiro %dx%d\n", leitor.tamanho,
+           (unsigned long long) leitor.configuracao.semente, leitor.configuracao.largura, leitor.configuracao.altura);
+    printf("Ações reproduzidas: %zu (duração original da partida: %.3f s)\n", total, leitor.instanteUs / 1e6);
+    if (leitor.corrompido) printf("⚠️  Gravação corrompida a partir do byte %zu\n", leitor.posicao);
+    printf("Tempo: %.3f s\n", duracao);
+    printf("Vazão: %.2f milhões de ações/s\n", duracao > 0 ? total / duracao / 1e6 : 0.0);
+    mostrarEstadoFinal(&estado);
+
+    // As peças da partida saem do gerador com a semente gravada; basta gerar
+    // de novo as que foram sorteadas
+    EstatisticasPecas estatisticas;
+    GeradorPecas gerador;
+    uint64_t sorteadas = estado.gerador.proximoId - 1;
+    inicializarEstatisticasPecas(&estatisticas);
+    inicializarGerador(&gerador, leitor.configuracao.semente, GERADOR_SACO);
+    acumularGerador(&estatisticas, &gerador, sorteadas);
+    printf("Peças sorteadas: %llu\n", (unsigned long long) sorteadas);
+    mostrarEstatisticasPecas(&estatisticas);
+
+    liberarJogo(&estado);
+    fecharLeitura(&leitor);
+    return leitor.corrompido;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "--gerar") == 0) {
+        uint64_t semente = argc > 4 ? strtoull(argv[4], NULL, 10) : 1;
+        return gerarArquivoAcoes(argv[2], atol(argv[3]), semente);
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--reproduzir") == 0) {
+        int repeticoes = argc > 3 ? atoi(argv[3]) : 1;
+        return reproduzirArquivoGravacao(argv[2], repeticoes > 0 ? repeticoes : 1);
+    }
+
+    if (argc >= 4 && strcmp(argv[1], "--converter") == 0) {
+        uint64_t semente = argc > 4 ? strtoull(argv[4], NULL, 10) : 1;
+        size_t capacidadeHistorico = argc > 5 ? strtoul(argv[5], NULL, 10) : HISTORICO_MAX;
+        return converterArquivoAcoes(argv[2], argv[3], semente, capacidadeHistorico);
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--estatisticas") == 0) {
+        uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+        ModoGerador modo = argc > 4 && strcmp(argv[4], "uniforme") == 0 ? GERADOR_UNIFORME : GERADOR_SACO;
+        for (int nivel = 0; argc > 5 && nivel < TOTAL_NIVEIS_SIMD; nivel++) {
+            if (strcmp(argv[5], nomeNivelSimd((NivelSimd) nivel)) != 0) continue;
+            if (!definirNivelSimdEstatisticas((NivelSimd) nivel)) {
+                fprintf(stderr, "Erro: esta CPU não suporta %s\n", argv[5]);
+                return 1;
+            }
+        }
+        return auditarGerador(strtoull(argv[2], NULL, 10), semente, modo);
+    }
+
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <arquivo> [repeticoes] [semente] [historico] [assincrono]\n", argv[0]);
+        fprintf(stderr, "     %s --gerar <arquivo> <quantidade> [semente]\n", argv[0]);
+        fprintf(stderr, "     %s --reproduzir <gravacao> [repeticoes]\n", argv[0]);
+        fprintf(stderr, "     %s --converter <arquivo> <gravacao> [semente] [historico]\n", argv[0]);
+        fprintf(stderr, "     %s --estatisticas <quantidade> [semente] [saco|uniforme] [escalar|ssse3|avx2]\n",
+                argv[0]);
+        return 1;
+    }
+
+    size_t quantidade;
+    unsigned char *acoes = carregarArquivoAcoes(argv[1], &quantidade);
+    if (acoes == NULL) return 1;
+
+    int repeticoes = argc > 2 ? atoi(argv[2]) : 1;
+    uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    size_t capacidadeHistorico = argc > 4 ? strtoul(argv[4], NULL, 10) : HISTORICO_MAX;
+    int assincrono = argc > 5 && strcmp(argv[5], "assincrono") == 0;
+
+    static ProdutorPecas produtor;
+    EstadoJogo estado;
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
+    configuracao.capacidadeHistorico = capacidadeHistorico;
+    configuracao.semente = semente;
+    if (!inicializarJogo(&estado, &configuracao)) {
+        fprintf(stderr, "Erro: memória insuficiente para o histórico!\n");
+        free(acoes);
+        return 1;
+    }
+
+    // Com "assincrono" as peças vêm da thread produtora; o resultado final
+    // tem de ser idêntico ao do modo normal
+    if (assincrono) {
+        if (!iniciarProdutor(&produtor, &estado.gerador)) {
+            fprintf(stderr, "Erro: não foi possível criar a thread do gerador!\n");
+            liberarJogo(&estado);
+            free(acoes);
+            return 1;
+        }
+        estado.produtor = &produtor;
+    }
+
+    // Laço principal: nenhuma saída (nem alocação) até o fim da simulação
+    long alocacoesAntes = alocacoesProcesso();
+    double inicio = relogioNs() / 1e9;
+    size_t aplicadas = 0;
+    for (int r = 0; r < repeticoes; r++) {
+        aplicadas += executarAcoes(&estado, acoes, quantidade);
+    }
+    double duracao = relogioNs() / 1e9 - inicio;
+    long alocacoes = alocacoesProcesso() - alocacoesAntes;
+
+    size_t total = quantidade * (size_t) repeticoes;
+    printf("=== SIMULAÇÃO CONCLUÍDA ===\n");
+    printf("Ações executadas: %zu (%zu aplicadas, %zu rejeitadas)\n", total, aplicadas, total - aplicadas);
+    printf("Tempo: %.3f s\n", duracao);
+    printf("Vazão: %.2f milhões de ações/s\n", duracao > 0 ? total / duracao / 1e6 : 0.0);
+    mostrarEstadoFinal(&estado);
+    if (alocacoesAntes >= 0) printf("Alocações no laço: %ld\n", alocacoes);
+    if (assincrono) printf("Fila do gerador vazia: %lu vezes\n", produtor.esperasConsumidor);
+
+    liberarJogo(&estado);
+    free(acoes);
+    return 0;
+}
@@ -0,0 +1,339 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ia.h"
+#include "metricas.h"
+#include "versus.h"
+
+// Versus do Tetris - Nível Mestre
+// Cada jogador roda num processo próprio (um "participante") e todos se
+// ligam dois a dois por sockets locais. A cada turno cada participante envia
+// aos outros um único byte, a ação do seu jogador, e espera a ação de todos
+// antes de avançar (lockstep): todos simulam as partidas de todos os
+// jogadores (ver versus.h) e, como a semente é a mesma, chegam ao mesmo
+// estado sem trocar nada além das ações. A cada INTERVALO_CONFERENCIA turnos
+// os participantes trocam também um resumo do estado, para detectar uma
+// dessincronização assim que ela acontece.
+//
+// Os jogadores são bots que emitem uma ação por turno (girar, mover, jogar),
+// cada um com pesos um pouco diferentes, para que as partidas divirjam.
+//
+// Uso:
+//   TETRIS_VERSUS [--jogadores N] [--turnos N] [--semente N] [--largura N] [--altura N]
+//                 [--profundidade N] [--orcamento MS]
+
+#define JOGADORES_PADRAO 2
+#define TURNOS_PADRAO 5000
+#define INTERVALO_CONFERENCIA 64
+
+// Máximo de ações gastas num lance antes de jogar a peça onde estiver
+#define MAX_PASSOS_LANCE 48
+
+// O que cada participante informa ao processo principal ao terminar
+typedef struct {
+    int indice;
+    int vivo;
+    int dessincronizado;        // turno em que os resumos divergiram + 1 (0 = nunca)
+    long turnos;
+    long linhas;
+    long linhasEnviadas;
+    long linhasRecebidas;
+    long bytesEnviados;
+    int64_t somaEsperaNs;       // do envio da ação até ter a de todos
+    int64_t maxEsperaNs;
+    uint64_t resumo;
+} RelatorioParticipante;
+
+// Lance em andamento: o bot já decidiu e emite uma ação por turno
+typedef struct {
+    Lance lance;
+    int ativo;
+    int trocou;
+    int passos;
+} PlanoBot;
+
+static int enviarTudo(int descritor, const void *dados, size_t tamanho) {
+    const char *origem = dados;
+    while (tamanho > 0) {
+        ssize_t enviados = write(descritor, origem, tamanho);
+        if (enviados < 0 && errno == EINTR) continue;
+        if (enviados <= 0) return 0;
+        origem += enviados;
+        tamanho -= (size_t) enviados;
+    }
+    return 1;
+}
+
+static int receberTudo(int descritor, void *dados, size_t tamanho) {
+    char *destino = dados;
+    while (tamanho > 0) {
+        ssize_t recebidos = read(descritor, destino, tamanho);
+        if (recebidos < 0 && errno == EINTR) continue;
+        if (recebidos <= 0) return 0;
+        destino += recebidos;
+        tamanho -= (size_t) recebidos;
+    }
+    return 1;
+}
+
+// Próxima ação do bot, um passo do lance decidido (na mesma ordem de aplicarLance)
+static AcaoJogo proximaAcaoBot(Ia *ia, PlanoBot *plano, EstadoJogo *estado) {
+    if (!plano->ativo) {
+        DecisaoIa decisao = decidirLance(ia, estado);
+        if (decisao.lance.tipo == LANCE_NENHUM) return ACAO_JOGAR;      // não cabe mais nada: perde
+        if (decisao.lance.tipo == LANCE_RESERVAR) return ACAO_RESERVAR;
+
+        plano->lance = decisao.lance;
+        plano->ativo = 1;
+        plano->trocou = 0;
+        plano->passos = 0;
+    }
+
+    const Lance *lance = &plano->lance;
+    AcaoJogo final = lance->tipo == LANCE_USAR_RESERVA ? ACAO_USAR_RESERVA : ACAO_JOGAR;
+    if (++plano->passos > MAX_PASSOS_LANCE) {
+        plano->ativo = 0;
+        return final;
+    }
+
+    if (lance->tipo == LANCE_TROCAR_E_JOGAR && !plano->trocou) {
+        plano->trocou = 1;
+        return ACAO_TROCAR;
+    }
+    if (estado->rotacaoMira != lance->rotacao) {
+        // O giro usa a peça da frente da fila, que no USAR_RESERVA não é a
+        // jogada. Se a rotação do lance não é mais alcançável, o lance é
+        // decidido de novo (só com rotações alcançáveis) em vez de gastar
+        // turnos em giros que o motor recusa.
+        TipoPeca frente = filaVazia(&estado->fila) ? PECA_NENHUMA : (TipoPeca) verFrenteFila(&estado->fila).tipo;
+        unsigned alcancaveis = frente != PECA_NENHUMA ? rotacoesAlcancaveis(estado, frente) : 0;
+        if (alcancaveis & (1u << lance->rotacao)) return ACAO_GIRAR;
+        if (plano->passos > 1) {
+            plano->ativo = 0;
+            return proximaAcaoBot(ia, plano, estado);
+        }
+    }
+    if (estado->colunaMira > lance->coluna) return ACAO_MOVER_ESQUERDA;
+    if (estado->colunaMira < lance->coluna) return ACAO_MOVER_DIREITA;
+
+    plano->ativo = 0;
+    return final;
+}
+
+// Laço de um participante: "conexoes[j]" liga ao participante j (-1 para ele mesmo)
+static void executarParticipante(int indice, int jogadores, const int *conexoes, const ConfiguracaoJogo *configuracao,
+                                 const ConfiguracaoIa *configuracaoIa, long turnos, RelatorioParticipante *relatorio) {
+    static PartidaVersus partida;
+    static Ia ia;
+    PlanoBot plano = {{LANCE_NENHUM, 0, 0}, 0, 0, 0};
+    unsigned char acoes[MAX_JOGADORES_VERSUS];
+    int sobreviventes = jogadores > 1 ? 1 : 0;      // a partida acaba quando só resta um
+
+    memset(relatorio, 0, sizeof(*relatorio));
+    relatorio->indice = indice;
+
+    // Pesos um pouco diferentes por jogador, senão todos jogariam igual
+    ConfiguracaoIa propria = *configuracaoIa;
+    propria.pesos.irregularidade *= 1.0 + 0.25 * indice;
+    propria.pesos.buracos *= 1.0 - 0.05 * indice;
+    if (!iniciarVersus(&partida, jogadores, configuracao) || !iniciarIa(&ia, &propria)) return;
+
+    while (partida.turno < turnos && partida.vivos > sobreviventes) {
+        EstadoJogo *meu = &partida.jogadores[indice];
+        unsigned char acao = partida.vivo[indice] ? (unsigned char) proximaAcaoBot(&ia, &plano, meu)
+                                                  : ACAO_NENHUMA_VERSUS;
+
+        // Troca das ações: envia a todos e depois espera a de cada um
+        int64_t inicio = relogioNs();
+        for (int j = 0; j < jogadores; j++) {
+            if (j != indice && !enviarTudo(conexoes[j], &acao, 1)) goto fim;
+        }
+        relatorio->bytesEnviados += jogadores - 1;
+        acoes[indice] = acao;
+        for (int j = 0; j < jogadores; j++) {
+            if (j != indice && !receberTudo(conexoes[j], &acoes[j], 1)) goto fim;
+        }
+        int64_t espera = relogioNs() - inicio;
+        relatorio->somaEsperaNs += espera;
+        if (espera > relatorio->maxEsperaNs) relatorio->maxEsperaNs = espera;
+
+        avancarVersus(&partida, acoes);
+
+        // Conferência periódica dos resumos
+        if (partida.turno % INTERVALO_CONFERENCIA == 0) {
+            uint64_t meuResumo = resumoVersus(&partida);
+            for (int j = 0; j < jogadores; j++) {
+                if (j != indice && !enviarTudo(conexoes[j], &meuResumo, sizeof(meuResumo))) goto fim;
+            }
+            relatorio->bytesEnviados += (jogadores - 1) * (long) sizeof(meuResumo);
+            for (int j = 0; j < jogadores; j++) {
+                uint64_t outro;
+                if (j == indice) continue;
+                if (!receberTudo(conexoes[j], &outro, sizeof(outro))) goto fim;
+                if (outro != meuResumo && relatorio->dessincronizado == 0) {
+                    relatorio->dessincronizado = (int) partida.turno + 1;
+                }
+            }
+            if (relatorio->dessincronizado) break;
+        }
+    }
+
+fim:
+    relatorio->turnos = partida.turno;
+    relatorio->vivo = partida.vivo[indice];
+    relatorio->linhas = partida.jogadores[indice].linhasRemovidas;
+    relatorio->linhasEnviadas = partida.linhasEnviadas[indice];
+    relatorio->linhasRecebidas = partida.linhasRecebidas[indice];
+    relatorio->resumo = resumoVersus(&partida);
+    encerrarIa(&ia);
+    liberarVersus(&partida);
+}
+
+static void mostrarRelatorios(const RelatorioParticipante *relatorios, int jogadores) {
+    int sincronizados = 1;
+
+    printf("\n=== VERSUS (%d jogadores, %ld turnos) ===\n", jogadores, relatorios[0].turnos);
+    printf("%-8s %-11s %8s %9s %10s %12s %15s %15s\n", "Jogador", "Situação", "Linhas", "Enviadas", "Recebidas",
+           "Bytes/turno", "Espera média", "Espera máxima");
+    for (int j = 0; j < jogadores; j++) {
+        const RelatorioParticipante *relatorio = &relatorios[j];
+        long turnos = relatorio->turnos > 0 ? relatorio->turnos : 1;
+
+        printf("%-8d %-10s %8ld %9ld %10ld %12.2f %11.1f µs %11.1f µs\n", j + 1,
+               relatorio->vivo ? "vivo" : "perdeu", relatorio->linhas, relatorio->linhasEnviadas,
+               relatorio->linhasRecebidas, (double) relatorio->bytesEnviados / turnos,
+               relatorio->somaEsperaNs / 1e3 / turnos, relatorio->maxEsperaNs / 1e3);
+        if (relatorio->resumo != relatorios[0].resumo || relatorio->dessincronizado) sincronizados = 0;
+    }
+
+    if (sincronizados) {
+        printf("✅ Todos os participantes terminaram no mesmo estado (resumo %016llx).\n",
+               (unsigned long long) relatorios[0].resumo);
+    } else {
+        printf("❌ Os participantes dessincronizaram!\n");
+        for (int j = 0; j < jogadores; j++) {
+            printf("   Jogador %d: resumo %016llx", j + 1, (unsigned long long) relatorios[j].resumo);
+            if (relatorios[j].dessincronizado) printf(", divergiu no turno %d", relatorios[j].dessincronizado - 1);
+            printf("\n");
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ConfiguracaoJogo configuracao = configuracaoPadrao();
+    ConfiguracaoIa configuracaoIa = configuracaoIaPadrao();
+    int jogadores = JOGADORES_PADRAO;
+    long turnos = TURNOS_PADRAO;
+
+    // Cada participante pensa numa thread só e sem tabela de transposição
+    configuracaoIa.threads = 1;
+    configuracaoIa.profundidade = 2;
+    configuracaoIa.orcamentoMs = 5.0;
+    configuracaoIa.megabytesTabela = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--jogadores") == 0 && i + 1 < argc) {
+            jogadores = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--turnos") == 0 && i + 1 < argc) {
+            turnos = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            configuracao.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--largura") == 0 && i + 1 < argc) {
+            configuracao.largura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--altura") == 0 && i + 1 < argc) {
+            configuracao.altura = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--profundidade") == 0 && i + 1 < argc) {
+            configuracaoIa.profundidade = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--orcamento") == 0 && i + 1 < argc) {
+            configuracaoIa.orcamentoMs = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (jogadores < 2 || jogadores > MAX_JOGADORES_VERSUS) {
+        fprintf(stderr, "Erro: o versus precisa de 2 a %d jogadores.\n", MAX_JOGADORES_VERSUS);
+        return 1;
+    }
+
+    // Um socket local para cada par de participantes
+    int conexoes[MAX_JOGADORES_VERSUS][MAX_JOGADORES_VERSUS];
+    for (int a = 0; a < jogadores; a++) {
+        conexoes[a][a] = -1;
+        for (int b = a + 1; b < jogadores; b++) {
+            int par[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, par) != 0) {
+                perror("socketpair");
+                return 1;
+            }
+            conexoes[a][b] = par[0];
+            conexoes[b][a] = par[1];
+        }
+    }
+    int relatos[2];
+    if (pipe(relatos) != 0) {
+        perror("pipe");
+        return 1;
+    }
+
+    // Um participante que cai não derruba os outros com SIGPIPE: eles veem o erro no envio
+    signal(SIGPIPE, SIG_IGN);
+    printf("Semente da partida: %llu | %d jogadores em lockstep\n", (unsigned long long) configuracao.semente,
+           jogadores);
+    fflush(stdout);
+
+    for (int j = 0; j < jogadores; j++) {
+        pid_t processo = fork();
+        if (processo < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (processo == 0) {
+            // Cada participante fica só com as próprias pontas
+            for (int a = 0; a < jogadores; a++) {
+                for (int b = 0; b < jogadores; b++) {
+                    if (a != j && a != b) close(conexoes[a][b]);
+                }
+            }
+            close(relatos[0]);
+
+            RelatorioParticipante relatorio;
+            executarParticipante(j, jogadores, conexoes[j], &configuracao, &configuracaoIa, turnos, &relatorio);
+            int sucesso = enviarTudo(relatos[1], &relatorio, sizeof(relatorio));
+            _exit(sucesso ? 0 : 1);
+        }
+    }
+
+    for (int a = 0; a < jogadores; a++) {
+        for (int b = 0; b < jogadores; b++) {
+            if (a != b) close(conexoes[a][b]);
+        }
+    }
+    close(relatos[1]);
+
+    // Os relatórios cabem numa escrita atômica do pipe, então não se misturam
+    RelatorioParticipante relatorios[MAX_JOGADORES_VERSUS];
+    int recebidos = 0;
+    RelatorioParticipante relatorio;
+    while (recebidos < jogadores && receberTudo(relatos[0], &relatorio, sizeof(relatorio))) {
+        if (relatorio.indice >= 0 && relatorio.indice < jogadores) relatorios[relatorio.indice] = relatorio;
+        recebidos++;
+    }
+    close(relatos[0]);
+    while (wait(NULL) > 0) {
+    }
+
+    if (recebidos < jogadores) {
+        fprintf(stderr, "Erro: só %d de %d participantes terminaram.\n", recebidos, jogadores);
+        return 1;
+    }
+    mostrarRelatorios(relatorios, jogadores);
+    return 0;
+}
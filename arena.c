@@ -0,0 +1,78 @@
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+// Funções da arena
+// Função para reservar "capacidade" bytes de uma vez (zerados)
+// Retorna 1 em caso de sucesso e 0 se não houver memória.
+int criarArena(Arena *arena, size_t capacidade) {
+    inicializarArena(arena, calloc(capacidade > 0 ? capacidade : 1, 1), capacidade);
+    arena->propria = 1;
+    if (arena->memoria == NULL) {
+        arena->capacidade = 0;
+        return 0;
+    }
+    return 1;
+}
+
+// Função para usar uma memória já existente como arena (ela continua sendo
+// de quem a forneceu)
+void inicializarArena(Arena *arena, void *memoria, size_t capacidade) {
+    arena->memoria = memoria;
+    arena->capacidade = capacidade;
+    arena->usado = 0;
+    arena->pico = 0;
+    arena->propria = 0;
+}
+
+void liberarArena(Arena *arena) {
+    if (arena->propria) free(arena->memoria);
+    arena->memoria = NULL;
+    arena->capacidade = 0;
+    arena->usado = 0;
+}
+
+// Funções do pool
+// Função para tirar da arena "capacidade" blocos e a pilha de livres
+// Retorna 1 em caso de sucesso e 0 se a arena não tiver espaço.
+int criarPoolArena(PoolBlocos *pool, Arena *arena, size_t tamanhoBloco, size_t alinhamento, int capacidade) {
+    pool->tamanhoBloco = (tamanhoBloco + alinhamento - 1) & ~(alinhamento - 1);
+    pool->blocos = alocarArena(arena, pool->tamanhoBloco * (size_t) capacidade, alinhamento);
+    pool->livres = alocarArena(arena, sizeof(int) * (size_t) capacidade, _Alignof(int));
+    if (pool->blocos == NULL || pool->livres == NULL) return 0;
+
+    // O bloco 0 fica no topo, então os primeiros blocos saem em ordem
+    pool->capacidade = capacidade;
+    pool->quantidadeLivres = capacidade;
+    for (int i = 0; i < capacidade; i++) {
+        pool->livres[i] = capacidade - 1 - i;
+    }
+    return 1;
+}
+
+// Retorna NULL se todos os blocos estiverem em uso
+void *alocarPool(PoolBlocos *pool) {
+    if (pool->quantidadeLivres == 0) return NULL;
+    return blocoPool(pool, pool->livres[--pool->quantidadeLivres]);
+}
+
+// O último bloco devolvido é o próximo a sair (provavelmente ainda no cache)
+void devolverPool(PoolBlocos *pool, void *bloco) {
+    pool->livres[pool->quantidadeLivres++] = indicePool(pool, bloco);
+}
+
+// Contagem de alocações
+// A contagem vem do contador carregado com LD_PRELOAD (contagem.c), quando
+// ele está presente; o programa em si não mexe no alocador.
+long alocacoesProcesso(void) {
+    static long (*contadas)(void);
+    static int procurado;
+
+    if (!procurado) {
+        contadas = (long (*)(void)) dlsym(RTLD_DEFAULT, "alocacoesContadas");
+        procurado = 1;
+    }
+    return contadas != NULL ? contadas() : -1;
+}
@@ -0,0 +1,84 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Alocadores sem malloc no caminho quente
+//
+// Arena: um bloco contíguo reservado de uma vez, de onde as alocações saem
+// avançando um ponteiro. Não há liberação individual: quem usa a arena para
+// rascunho marca a posição, aloca o que precisa e volta à marca, ou zera a
+// arena inteira no início de cada jogada.
+//
+// Pool: blocos de tamanho fixo tirados de uma arena, com uma pilha de índices
+// livres. Alocar e devolver custam O(1) e o conteúdo de um bloco devolvido
+// fica intacto (o índice do bloco também serve de identificador).
+
+typedef struct {
+    unsigned char *memoria;
+    size_t capacidade;
+    size_t usado;
+    size_t pico;                // maior uso desde a criação
+    int propria;                // memória alocada por criarArena
+} Arena;
+
+typedef struct {
+    unsigned char *blocos;
+    size_t tamanhoBloco;        // já arredondado para o alinhamento
+    int capacidade;
+    int *livres;                // pilha de índices livres
+    int quantidadeLivres;
+} PoolBlocos;
+
+// Funções da arena
+int criarArena(Arena *arena, size_t capacidade);
+void inicializarArena(Arena *arena, void *memoria, size_t capacidade);
+void liberarArena(Arena *arena);
+
+// Função para alocar "tamanho" bytes alinhados a "alinhamento" (potência de dois)
+// Retorna NULL se a arena não tiver espaço; nada é alocado nesse caso.
+static inline void *alocarArena(Arena *arena, size_t tamanho, size_t alinhamento) {
+    uintptr_t base = (uintptr_t) arena->memoria;
+    uintptr_t inicio = (base + arena->usado + alinhamento - 1) & ~(uintptr_t) (alinhamento - 1);
+    size_t deslocamento = (size_t) (inicio - base);
+
+    if (deslocamento > arena->capacidade || tamanho > arena->capacidade - deslocamento) return NULL;
+
+    arena->usado = deslocamento + tamanho;
+    if (arena->usado > arena->pico) arena->pico = arena->usado;
+    return (void *) inicio;
+}
+
+// Posição atual da arena, para voltar a ela depois de um trecho de rascunho
+static inline size_t marcaArena(const Arena *arena) {
+    return arena->usado;
+}
+
+static inline void voltarArena(Arena *arena, size_t marca) {
+    arena->usado = marca;
+}
+
+static inline void reiniciarArena(Arena *arena) {
+    arena->usado = 0;
+}
+
+// Funções do pool
+int criarPoolArena(PoolBlocos *pool, Arena *arena, size_t tamanhoBloco, size_t alinhamento, int capacidade);
+void *alocarPool(PoolBlocos *pool);
+void devolverPool(PoolBlocos *pool, void *bloco);
+
+static inline void *blocoPool(const PoolBlocos *pool, int indice) {
+    return pool->blocos + (size_t) indice * pool->tamanhoBloco;
+}
+
+static inline int indicePool(const PoolBlocos *pool, const void *bloco) {
+    return (int) (((const unsigned char *) bloco - pool->blocos) / pool->tamanhoBloco);
+}
+
+// Contagem de alocações do processo (malloc e afins), para conferir que um
+// trecho não aloca nada. Só está disponível com o contador de contagem.c
+// carregado por LD_PRELOAD; sem ele, retorna -1.
+long alocacoesProcesso(void);
+
+#endif
@@ -0,0 +1,156 @@
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Contador de alocações para LD_PRELOAD
+// Biblioteca à parte, que nenhum programa liga: carregada com
+//     LD_PRELOAD=build/release/libcontagem.so build/release/TETRIS_SIMULADOR ...
+// ela substitui as funções de alocação por versões que contam a chamada e
+// repassam às originais (achadas com dlsym). Os programas leem a contagem
+// por alocacoesProcesso (arena.h), que a procura com dlsym; sem a
+// biblioteca carregada, a contagem fica indisponível e o alocador do
+// programa é o da libc, sem nenhuma mudança.
+
+static atomic_long alocacoes;
+
+static void *(*mallocOriginal)(size_t);
+static void *(*callocOriginal)(size_t, size_t);
+static void *(*reallocOriginal)(void *, size_t);
+static void *(*reallocarrayOriginal)(void *, size_t, size_t);
+static void *(*alignedAllocOriginal)(size_t, size_t);
+static int (*posixMemalignOriginal)(void **, size_t, size_t);
+static void *(*memalignOriginal)(size_t, size_t);
+static void *(*vallocOriginal)(size_t);
+static void *(*pvallocOriginal)(size_t);
+static void (*freeOriginal)(void *);
+
+// O próprio dlsym pode alocar enquanto as originais são procuradas; essas
+// alocações saem desta reserva (memória estática, já zerada) e nunca são liberadas
+static _Alignas(max_align_t) unsigned char reserva[8192];
+static size_t usadoReserva;
+static int procurando;
+
+static void *alocarReserva(size_t tamanho) {
+    size_t inicio = (usadoReserva + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+    if (tamanho > sizeof(reserva) - inicio) return NULL;
+    usadoReserva = inicio + tamanho;
+    return reserva + inicio;
+}
+
+static int daReserva(const void *memoria) {
+    const unsigned char *p = memoria;
+    return p >= reserva && p < reserva + sizeof(reserva);
+}
+
+// Procura as funções originais; roda antes das threads do programa
+// (no construtor, ou na primeira alocação se ela vier antes)
+static void procurarOriginais(void) {
+    procurando = 1;
+    mallocOriginal = dlsym(RTLD_NEXT, "malloc");
+    callocOriginal = dlsym(RTLD_NEXT, "calloc");
+    reallocOriginal = dlsym(RTLD_NEXT, "realloc");
+    reallocarrayOriginal = dlsym(RTLD_NEXT, "reallocarray");
+    alignedAllocOriginal = dlsym(RTLD_NEXT, "aligned_alloc");
+    posixMemalignOriginal = dlsym(RTLD_NEXT, "posix_memalign");
+    memalignOriginal = dlsym(RTLD_NEXT, "memalign");
+    vallocOriginal = dlsym(RTLD_NEXT, "valloc");
+    pvallocOriginal = dlsym(RTLD_NEXT, "pvalloc");
+    freeOriginal = dlsym(RTLD_NEXT, "free");
+    procurando = 0;
+}
+
+__attribute__((constructor)) static void iniciarContagem(void) {
+    if (freeOriginal == NULL) procurarOriginais();
+}
+
+static inline void contarAlocacao(void) {
+    atomic_fetch_add_explicit(&alocacoes, 1, memory_order_relaxed);
+}
+
+// Contagem desde o início do processo (procurada pelos programas com dlsym)
+long alocacoesContadas(void) {
+    return atomic_load_explicit(&alocacoes, memory_order_relaxed);
+}
+
+void *malloc(size_t tamanho) {
+    if (procurando) return alocarReserva(tamanho);
+    if (mallocOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return mallocOriginal(tamanho);
+}
+
+void *calloc(size_t quantidade, size_t tamanho) {
+    if (procurando) {
+        size_t total;
+        return __builtin_mul_overflow(quantidade, tamanho, &total) ? NULL : alocarReserva(total);
+    }
+    if (callocOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return callocOriginal(quantidade, tamanho);
+}
+
+void *realloc(void *memoria, size_t tamanho) {
+    if (!procurando && reallocOriginal == NULL) procurarOriginais();
+    if (!procurando) contarAlocacao();
+    if (procurando || daReserva(memoria)) {
+        // O tamanho antigo não é conhecido: copia o que couber até o fim da reserva
+        void *nova = procurando ? alocarReserva(tamanho) : mallocOriginal(tamanho);
+        if (memoria == NULL || !daReserva(memoria)) return nova;
+        size_t disponivel = (size_t) (reserva + sizeof(reserva) - (unsigned char *) memoria);
+        if (nova != NULL) memcpy(nova, memoria, tamanho < disponivel ? tamanho : disponivel);
+        return nova;
+    }
+    return reallocOriginal(memoria, tamanho);
+}
+
+void *reallocarray(void *memoria, size_t quantidade, size_t tamanho) {
+    size_t total;
+    if (__builtin_mul_overflow(quantidade, tamanho, &total)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return realloc(memoria, total);
+}
+
+// As alinhadas repassam o alinhamento sem conferir: as originais já recusam
+// os inválidos (EINVAL)
+void *aligned_alloc(size_t alinhamento, size_t tamanho) {
+    if (alignedAllocOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return alignedAllocOriginal(alinhamento, tamanho);
+}
+
+int posix_memalign(void **memoria, size_t alinhamento, size_t tamanho) {
+    if (posixMemalignOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return posixMemalignOriginal(memoria, alinhamento, tamanho);
+}
+
+void *memalign(size_t alinhamento, size_t tamanho) {
+    if (memalignOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return memalignOriginal(alinhamento, tamanho);
+}
+
+void *valloc(size_t tamanho) {
+    if (vallocOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return vallocOriginal(tamanho);
+}
+
+void *pvalloc(size_t tamanho) {
+    if (pvallocOriginal == NULL) procurarOriginais();
+    contarAlocacao();
+    return pvallocOriginal(tamanho);
+}
+
+void free(void *memoria) {
+    if (memoria == NULL || daReserva(memoria)) return;
+    if (freeOriginal == NULL) procurarOriginais();
+    freeOriginal(memoria);
+}
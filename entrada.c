@@ -0,0 +1,49 @@
+#define _GNU_SOURCE
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "entrada.h"
+
+// Função para colocar o terminal em modo bruto
+// Retorna 1 em caso de sucesso e 0 se a entrada não for um terminal.
+int ativarModoBruto(EntradaTerminal *entrada) {
+    entrada->ativo = 0;
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &entrada->original) != 0) return 0;
+
+    struct termios bruto = entrada->original;
+    bruto.c_lflag &= ~(ICANON | ECHO);  // mantém ISIG para o Ctrl+C continuar funcionando
+    bruto.c_cc[VMIN] = 0;
+    bruto.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &bruto) != 0) return 0;
+
+    entrada->ativo = 1;
+    return 1;
+}
+
+// Função para devolver o terminal ao estado original
+void restaurarTerminal(EntradaTerminal *entrada) {
+    if (!entrada->ativo) return;
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &entrada->original);
+    entrada->ativo = 0;
+}
+
+// Espera no máximo "esperaMaximaNs" por uma tecla (0 = só verifica)
+// Retorna o código da tecla, TECLA_NENHUMA se nada foi pressionado ou
+// TECLA_FIM se a entrada foi fechada.
+int lerTecla(int64_t esperaMaximaNs) {
+    struct pollfd descritor = {STDIN_FILENO, POLLIN, 0};
+    struct timespec espera = {esperaMaximaNs / 1000000000, esperaMaximaNs % 1000000000};
+
+    int prontos = ppoll(&descritor, 1, &espera, NULL);
+    if (prontos <= 0) return TECLA_NENHUMA;
+    if (!(descritor.revents & POLLIN)) return TECLA_FIM;
+
+    unsigned char tecla;
+    ssize_t lidos = read(STDIN_FILENO, &tecla, 1);
+    if (lidos == 0) return TECLA_FIM;
+    if (lidos < 0) return TECLA_NENHUMA;
+
+    return tecla;
+}
@@ -0,0 +1,26 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include <stdint.h>
+#include <termios.h>
+
+#include "relogio.h"
+
+// Entrada do teclado sem bloqueio
+// Coloca o terminal em modo bruto (sem eco e sem esperar o Enter) e lê teclas
+// com ppoll(), com tempo máximo de espera, para que o laço do jogo nunca fique
+// parado aguardando o jogador.
+
+#define TECLA_NENHUMA -1
+#define TECLA_FIM -2
+
+typedef struct {
+    struct termios original;
+    int ativo;
+} EntradaTerminal;
+
+int ativarModoBruto(EntradaTerminal *entrada);
+void restaurarTerminal(EntradaTerminal *entrada);
+int lerTecla(int64_t esperaMaximaNs);
+
+#endif
@@ -0,0 +1,368 @@
+#include <string.h>
+
+#include "estatisticas.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ESTATISTICAS_X86 1
+#include <immintrin.h>
+#endif
+
+// Os sacos e a contagem percorrem a sequência em blocos deste tamanho, para
+// que a segunda passada encontre o bloco ainda na cache
+#define BLOCO_ESTATISTICAS (1 << 14)
+
+// Quantas peças do gerador são produzidas de cada vez em acumularGerador
+#define LOTE_GERADOR (1 << 16)
+
+// Cada tipo vira um bit; tipos inválidos viram 128. A soma de 7 potências de
+// dois só dá 0x7F se forem todas diferentes, então um saco está correto
+// exatamente quando a soma dos bits das suas peças é 0x7F.
+#define SACO_COMPLETO 0x7F
+
+static inline unsigned bitTipo(unsigned char tipo) {
+    return tipo < TOTAL_TIPOS_PECA ? 1u << tipo : 0x80;
+}
+
+// Estado das secas copiado para variáveis locais durante os laços (o vetor de
+// tipos é de char, que pode apontar para qualquer coisa, e sem a cópia o
+// compilador recarregaria a struct a cada peça)
+typedef struct {
+    uint64_t atual;
+    uint64_t maior;
+    uint64_t longas;
+} Secas;
+
+static inline void encerrarSeca(Secas *secas, uint64_t seca) {
+    if (seca > secas->maior) secas->maior = seca;
+    secas->longas += seca > LIMITE_SECA_SACO;
+}
+
+// Indica se a máscara tem 13 (LIMITE_SECA_SACO + 1) zeros seguidos nos
+// primeiros "largura" bits: cada passo deixa marcados só os bits que iniciam
+// uma sequência de zeros de 2, 4, 8 e 13 posições
+static inline int temSecaLonga(uint32_t mascara, int largura) {
+    uint32_t zeros = ~mascara & (largura == 32 ? ~0u : (1u << largura) - 1);
+    zeros &= zeros >> 1;
+    zeros &= zeros >> 2;
+    zeros &= zeros >> 4;
+    zeros &= zeros >> 5;
+    return zeros != 0;
+}
+
+// Atualiza as secas com a máscara das posições com I de um trecho de "largura" peças
+static inline void registrarPecasI(Secas *secas, uint32_t mascara, int largura) {
+    // Caminho rápido (o comum com o saco de 7): a maior seca já chegou ao
+    // limite e nenhuma seca do trecho passa dele, então só a seca em
+    // andamento muda
+    if (mascara != 0 && secas->maior >= LIMITE_SECA_SACO &&
+        secas->atual + (uint64_t) __builtin_ctz(mascara) <= LIMITE_SECA_SACO && !temSecaLonga(mascara, largura)) {
+        secas->atual = (uint64_t) (largura - 32 + __builtin_clz(mascara));
+        return;
+    }
+
+    int anterior = -1;
+    while (mascara) {
+        int posicao = __builtin_ctz(mascara);
+        encerrarSeca(secas, secas->atual + (uint64_t) (posicao - anterior - 1));
+        secas->atual = 0;
+        anterior = posicao;
+        mascara &= mascara - 1;
+    }
+    secas->atual += (uint64_t) (largura - 1 - anterior);
+}
+
+// Versões escalares
+static void contarEscalar(uint64_t *contagem, Secas *secasSaida, const unsigned char *tipos, size_t quantidade) {
+    Secas local = *secasSaida, *secas = &local;
+    uint64_t contagemLocal[TOTAL_TIPOS_PECA + 1] = {0};
+    for (size_t i = 0; i < quantidade; i++) {
+        unsigned char tipo = tipos[i];
+        contagemLocal[tipo < TOTAL_TIPOS_PECA ? tipo : TOTAL_TIPOS_PECA]++;
+        if (tipo == PECA_I) {
+            encerrarSeca(secas, secas->atual);
+            secas->atual = 0;
+        } else {
+            secas->atual++;
+        }
+    }
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) contagem[t] += contagemLocal[t];
+    *secasSaida = local;
+}
+
+// Confere os sacos inteiros no início de "tipos" e retorna quantas peças consumiu
+static size_t verificarSacosEscalar(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade) {
+    size_t i = 0;
+    uint64_t irregulares = 0;
+    for (; i + TOTAL_TIPOS_PECA <= quantidade; i += TOTAL_TIPOS_PECA) {
+        unsigned soma = 0;
+        for (int k = 0; k < TOTAL_TIPOS_PECA; k++) soma += bitTipo(tipos[i + k]);
+        irregulares += soma != SACO_COMPLETO;
+    }
+    estatisticas->sacos += i / TOTAL_TIPOS_PECA;
+    estatisticas->sacosIrregulares += irregulares;
+    return i;
+}
+
+#ifdef ESTATISTICAS_X86
+// Versões SSSE3: 16 peças por iteração na contagem e 2 sacos na conferência
+__attribute__((target("ssse3")))
+static uint64_t somarBytesSse(__m128i bytes) {
+    // Cada metade soma no máximo 8 * 255, então cabe em 16 bits
+    __m128i somas = _mm_sad_epu8(bytes, _mm_setzero_si128());
+    return (uint64_t) _mm_extract_epi16(somas, 0) + (uint64_t) _mm_extract_epi16(somas, 4);
+}
+
+__attribute__((target("ssse3")))
+static void contarSsse3(uint64_t *contagem, Secas *secasSaida, const unsigned char *tipos, size_t quantidade) {
+    Secas local = *secasSaida, *secas = &local;
+    size_t i = 0;
+    while (quantidade - i >= 16) {
+        // Os contadores de um byte aguentam 255 iterações
+        size_t limite = quantidade - i >= 255 * 16 ? i + 255 * 16 : quantidade - (quantidade - i) % 16;
+        __m128i acumulados[TOTAL_TIPOS_PECA];
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) acumulados[t] = _mm_setzero_si128();
+
+        for (; i < limite; i += 16) {
+            __m128i bloco = _mm_loadu_si128((const __m128i *) (tipos + i));
+            __m128i pecasI = _mm_cmpeq_epi8(bloco, _mm_set1_epi8(PECA_I));
+            acumulados[PECA_I] = _mm_sub_epi8(acumulados[PECA_I], pecasI);
+            for (int t = PECA_O; t < TOTAL_TIPOS_PECA; t++) {
+                acumulados[t] = _mm_sub_epi8(acumulados[t], _mm_cmpeq_epi8(bloco, _mm_set1_epi8((char) t)));
+            }
+            registrarPecasI(secas, (uint32_t) _mm_movemask_epi8(pecasI), 16);
+        }
+
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) contagem[t] += somarBytesSse(acumulados[t]);
+    }
+    contarEscalar(contagem, secas, tipos + i, quantidade - i);
+    *secasSaida = local;
+}
+
+// Cada carga de 16 bytes cobre dois sacos (14 bytes): os tipos viram bits por
+// uma tabela (pshufb), os sacos são separados em metades de 8 bytes com um
+// zero no fim e a soma de cada metade sai de uma instrução psadbw
+__attribute__((target("ssse3")))
+static size_t verificarSacosSsse3(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade) {
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+    const __m128i separar = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, -1, 7, 8, 9, 10, 11, 12, 13, -1);
+    const __m128i completo = _mm_set1_epi64x(SACO_COMPLETO);
+    size_t i = 0;
+    uint64_t irregulares = 0;
+
+    for (; i + 16 <= quantidade; i += 2 * TOTAL_TIPOS_PECA) {
+        __m128i bloco = _mm_loadu_si128((const __m128i *) (tipos + i));
+        bloco = _mm_min_epu8(bloco, _mm_set1_epi8(TOTAL_TIPOS_PECA));
+        bloco = _mm_shuffle_epi8(_mm_shuffle_epi8(bits, bloco), separar);
+        __m128i iguais = _mm_cmpeq_epi32(_mm_sad_epu8(bloco, _mm_setzero_si128()), completo);
+        int mascara = _mm_movemask_epi8(iguais);
+        irregulares += ((mascara & 0x00FF) != 0x00FF) + ((mascara & 0xFF00) != 0xFF00);
+    }
+    estatisticas->sacos += i / TOTAL_TIPOS_PECA;
+    estatisticas->sacosIrregulares += irregulares;
+    return i;
+}
+
+// Versões AVX2: 32 peças por iteração na contagem e 4 sacos na conferência
+__attribute__((target("avx2")))
+static uint64_t somarBytesAvx2(__m256i bytes) {
+    __m256i somas = _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+    __m128i metade = _mm_add_epi64(_mm256_castsi256_si128(somas), _mm256_extracti128_si256(somas, 1));
+    return (uint64_t) _mm_extract_epi16(metade, 0) + (uint64_t) _mm_extract_epi16(metade, 4);
+}
+
+__attribute__((target("avx2")))
+static void contarAvx2(uint64_t *contagem, Secas *secasSaida, const unsigned char *tipos, size_t quantidade) {
+    Secas local = *secasSaida, *secas = &local;
+    size_t i = 0;
+    while (quantidade - i >= 32) {
+        size_t limite = quantidade - i >= 255 * 32 ? i + 255 * 32 : quantidade - (quantidade - i) % 32;
+        __m256i acumulados[TOTAL_TIPOS_PECA];
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) acumulados[t] = _mm256_setzero_si256();
+
+        for (; i < limite; i += 32) {
+            __m256i bloco = _mm256_loadu_si256((const __m256i *) (tipos + i));
+            __m256i pecasI = _mm256_cmpeq_epi8(bloco, _mm256_set1_epi8(PECA_I));
+            acumulados[PECA_I] = _mm256_sub_epi8(acumulados[PECA_I], pecasI);
+            for (int t = PECA_O; t < TOTAL_TIPOS_PECA; t++) {
+                acumulados[t] = _mm256_sub_epi8(acumulados[t], _mm256_cmpeq_epi8(bloco, _mm256_set1_epi8((char) t)));
+            }
+            registrarPecasI(secas, (uint32_t) _mm256_movemask_epi8(pecasI), 32);
+        }
+
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) contagem[t] += somarBytesAvx2(acumulados[t]);
+    }
+    contarEscalar(contagem, secas, tipos + i, quantidade - i);
+    *secasSaida = local;
+}
+
+// Mesma ideia da versão SSSE3, com duas cargas de 16 bytes (4 sacos) por iteração
+__attribute__((target("avx2")))
+static size_t verificarSacosAvx2(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade) {
+    const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+                                          1, 2, 4, 8, 16, 32, 64, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+    const __m256i separar = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, -1, 7, 8, 9, 10, 11, 12, 13, -1,
+                                             0, 1, 2, 3, 4, 5, 6, -1, 7, 8, 9, 10, 11, 12, 13, -1);
+    const __m256i completo = _mm256_set1_epi64x(SACO_COMPLETO);
+    size_t i = 0;
+    uint64_t irregulares = 0;
+
+    for (; i + 2 * TOTAL_TIPOS_PECA + 16 <= quantidade; i += 4 * TOTAL_TIPOS_PECA) {
+        __m128i baixo = _mm_loadu_si128((const __m128i *) (tipos + i));
+        __m128i alto = _mm_loadu_si128((const __m128i *) (tipos + i + 2 * TOTAL_TIPOS_PECA));
+        __m256i bloco = _mm256_inserti128_si256(_mm256_castsi128_si256(baixo), alto, 1);
+        bloco = _mm256_min_epu8(bloco, _mm256_set1_epi8(TOTAL_TIPOS_PECA));
+        bloco = _mm256_shuffle_epi8(_mm256_shuffle_epi8(bits, bloco), separar);
+        __m256i iguais = _mm256_cmpeq_epi64(_mm256_sad_epu8(bloco, _mm256_setzero_si256()), completo);
+        irregulares += 4 - __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(iguais)));
+    }
+    estatisticas->sacos += i / TOTAL_TIPOS_PECA;
+    estatisticas->sacosIrregulares += irregulares;
+    return i;
+}
+#endif
+
+// Laços internos de cada nível
+typedef struct {
+    const char *nome;
+    void (*contar)(uint64_t *contagem, Secas *secas, const unsigned char *tipos, size_t quantidade);
+    size_t (*verificarSacos)(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade);
+} NucleoEstatisticas;
+
+static const NucleoEstatisticas NUCLEOS[TOTAL_NIVEIS_SIMD] = {
+    [SIMD_ESCALAR] = {"escalar", contarEscalar, verificarSacosEscalar},
+#ifdef ESTATISTICAS_X86
+    [SIMD_SSSE3] = {"ssse3", contarSsse3, verificarSacosSsse3},
+    [SIMD_AVX2] = {"avx2", contarAvx2, verificarSacosAvx2},
+#else
+    [SIMD_SSSE3] = {"ssse3", NULL, NULL},
+    [SIMD_AVX2] = {"avx2", NULL, NULL},
+#endif
+};
+
+static NivelSimd nivelAtual = SIMD_ESCALAR;
+
+static int nivelSuportado(NivelSimd nivel) {
+#ifdef ESTATISTICAS_X86
+    switch (nivel) {
+        case SIMD_ESCALAR: return 1;
+        case SIMD_SSSE3: return __builtin_cpu_supports("ssse3");
+        case SIMD_AVX2: return __builtin_cpu_supports("avx2");
+        default: return 0;
+    }
+#else
+    return nivel == SIMD_ESCALAR;
+#endif
+}
+
+// Escolhe o melhor nível na carga do programa, antes de qualquer thread
+__attribute__((constructor))
+static void escolherNivelSimd(void) {
+#ifdef ESTATISTICAS_X86
+    __builtin_cpu_init();
+#endif
+    for (int nivel = TOTAL_NIVEIS_SIMD - 1; nivel >= 0; nivel--) {
+        if (nivelSuportado((NivelSimd) nivel)) {
+            nivelAtual = (NivelSimd) nivel;
+            return;
+        }
+    }
+}
+
+NivelSimd nivelSimdEstatisticas(void) {
+    return nivelAtual;
+}
+
+// Força um nível (para comparar as versões); retorna 0 se a CPU não o suporta
+int definirNivelSimdEstatisticas(NivelSimd nivel) {
+    if ((unsigned) nivel >= TOTAL_NIVEIS_SIMD || !nivelSuportado(nivel)) return 0;
+    nivelAtual = nivel;
+    return 1;
+}
+
+const char *nomeNivelSimd(NivelSimd nivel) {
+    return (unsigned) nivel < TOTAL_NIVEIS_SIMD ? NUCLEOS[nivel].nome : "?";
+}
+
+void inicializarEstatisticasPecas(EstatisticasPecas *estatisticas) {
+    memset(estatisticas, 0, sizeof(*estatisticas));
+}
+
+// Completa o saco que ficou pela metade
+static size_t continuarSaco(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade) {
+    size_t i = 0;
+    while (i < quantidade && estatisticas->posicaoSaco < TOTAL_TIPOS_PECA) {
+        estatisticas->somaSaco += bitTipo(tipos[i++]);
+        estatisticas->posicaoSaco++;
+    }
+    if (estatisticas->posicaoSaco == TOTAL_TIPOS_PECA) {
+        estatisticas->sacos++;
+        estatisticas->sacosIrregulares += estatisticas->somaSaco != SACO_COMPLETO;
+        estatisticas->somaSaco = 0;
+        estatisticas->posicaoSaco = 0;
+    }
+    return i;
+}
+
+// Função para acumular uma sequência de tipos (um byte por peça)
+void acumularTipos(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade) {
+    const NucleoEstatisticas *nucleo = &NUCLEOS[nivelAtual];
+    Secas secas = {estatisticas->secaAtual, estatisticas->maiorSeca, estatisticas->secasLongas};
+
+    for (size_t inicio = 0; inicio < quantidade; inicio += BLOCO_ESTATISTICAS) {
+        size_t tamanho = quantidade - inicio < BLOCO_ESTATISTICAS ? quantidade - inicio : BLOCO_ESTATISTICAS;
+        const unsigned char *bloco = tipos + inicio;
+
+        nucleo->contar(estatisticas->contagem, &secas, bloco, tamanho);
+
+        size_t i = 0;
+        if (estatisticas->posicaoSaco > 0) i = continuarSaco(estatisticas, bloco, tamanho);
+        i += nucleo->verificarSacos(estatisticas, bloco + i, tamanho - i);
+        if (i < tamanho) i += verificarSacosEscalar(estatisticas, bloco + i, tamanho - i);
+        if (i < tamanho) continuarSaco(estatisticas, bloco + i, tamanho - i);
+    }
+
+    estatisticas->total += quantidade;
+    estatisticas->secaAtual = secas.atual;
+    estatisticas->maiorSeca = secas.maior > secas.atual ? secas.maior : secas.atual;
+    estatisticas->secasLongas = secas.longas;
+
+    uint64_t validas = 0;
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) validas += estatisticas->contagem[t];
+    estatisticas->contagem[TOTAL_TIPOS_PECA] = estatisticas->total - validas;
+}
+
+// Função para acumular as peças de uma fila, da frente para o fim
+void acumularFilaPecas(EstatisticasPecas *estatisticas, const FilaPecas *fila) {
+    const unsigned char *primeiro, *segundo;
+    size_t tamanhoPrimeiro, tamanhoSegundo;
+    trechosTiposFilaPecas(fila, &primeiro, &tamanhoPrimeiro, &segundo, &tamanhoSegundo);
+    acumularTipos(estatisticas, primeiro, tamanhoPrimeiro);
+    acumularTipos(estatisticas, segundo, tamanhoSegundo);
+}
+
+// Função para acumular as próximas "quantidade" peças de um gerador
+void acumularGerador(EstatisticasPecas *estatisticas, GeradorPecas *gerador, uint64_t quantidade) {
+    static _Thread_local unsigned char lote[LOTE_GERADOR];
+
+    while (quantidade > 0) {
+        size_t tamanho = quantidade < LOTE_GERADOR ? (size_t) quantidade : LOTE_GERADOR;
+        gerarLoteTipos(gerador, lote, tamanho);
+        acumularTipos(estatisticas, lote, tamanho);
+        quantidade -= tamanho;
+    }
+}
+
+// Qui-quadrado da frequência dos 7 tipos contra a distribuição uniforme
+// (6 graus de liberdade: acima de ~22.5 a chance de ser acaso é menor que 0.1%)
+double quiQuadradoPecas(const EstatisticasPecas *estatisticas) {
+    uint64_t validas = estatisticas->total - estatisticas->contagem[TOTAL_TIPOS_PECA];
+    if (validas == 0) return 0.0;
+
+    double esperado = (double) validas / TOTAL_TIPOS_PECA;
+    double soma = 0.0;
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+        double diferenca = (double) estatisticas->contagem[t] - esperado;
+        soma += diferenca * diferenca / esperado;
+    }
+    return soma;
+}
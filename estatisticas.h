@@ -0,0 +1,54 @@
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "filapecas.h"
+#include "gerador.h"
+
+// Estatísticas de sequências de peças
+// Frequência de cada tipo, "secas" de peças I (quantas peças seguidas sem um
+// I) e conferência dos sacos de 7, calculadas sobre vetores de tipos (um byte
+// por peça, como em FilaPecas e gerarLoteTipos). Os laços internos têm versões
+// SSSE3 e AVX2, escolhidas conforme a CPU na carga do programa, e uma versão
+// escalar para as demais arquiteturas. Todas dão exatamente o mesmo resultado.
+//
+// As estatísticas são acumulativas: uma sequência pode ser entregue em
+// pedaços de qualquer tamanho, com o mesmo resultado de uma entrega só.
+
+// Maior seca possível com o gerador de saco (um I no início de um saco e o
+// seguinte no fim do próximo)
+#define LIMITE_SECA_SACO 12
+
+// Conjuntos de instruções usados nos laços internos
+typedef enum {
+    SIMD_ESCALAR = 0,
+    SIMD_SSSE3,
+    SIMD_AVX2,
+    TOTAL_NIVEIS_SIMD
+} NivelSimd;
+
+typedef struct {
+    uint64_t total;
+    uint64_t contagem[TOTAL_TIPOS_PECA + 1];    // por TipoPeca; a última posição conta tipos inválidos
+    uint64_t secaAtual;         // peças desde o último I (ou desde o início)
+    uint64_t maiorSeca;
+    uint64_t secasLongas;       // secas encerradas maiores que LIMITE_SECA_SACO
+    uint64_t sacos;             // grupos de 7 peças, alinhados ao início da sequência
+    uint64_t sacosIrregulares;  // grupos sem os 7 tipos
+    unsigned somaSaco;          // grupo incompleto entre duas chamadas
+    int posicaoSaco;
+} EstatisticasPecas;
+
+void inicializarEstatisticasPecas(EstatisticasPecas *estatisticas);
+void acumularTipos(EstatisticasPecas *estatisticas, const unsigned char *tipos, size_t quantidade);
+void acumularFilaPecas(EstatisticasPecas *estatisticas, const FilaPecas *fila);
+void acumularGerador(EstatisticasPecas *estatisticas, GeradorPecas *gerador, uint64_t quantidade);
+double quiQuadradoPecas(const EstatisticasPecas *estatisticas);
+
+NivelSimd nivelSimdEstatisticas(void);
+int definirNivelSimdEstatisticas(NivelSimd nivel);
+const char *nomeNivelSimd(NivelSimd nivel);
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef FILA_H
+#define FILA_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Fila circular genérica
+// Gera o tipo da fila e suas funções para qualquer tipo de elemento, de forma
+// que os três níveis do jogo compartilhem a mesma implementação.
+//
+// O armazenamento sempre tem tamanho potência de dois, então o índice circular
+// é calculado com uma máscara (i & mascara) em vez do resto da divisão. A
+// capacidade lógica continua sendo a pedida (por exemplo, 5 peças ocupam um
+// armazenamento de 8 posições, mas a fila fica cheia com 5).
+//
+// Duas variantes:
+//   FILA_DEFINIR(Nome, Tipo, CAPACIDADE, Sufixo, VAZIO)
+//       capacidade fixada em tempo de compilação, armazenamento dentro da struct
+//   FILA_DINAMICA_DEFINIR(Nome, Tipo, Sufixo, VAZIO)
+//       capacidade escolhida em tempo de execução com criarFila##Sufixo()
+// e uma variante concorrente, com interface própria (ver o fim do arquivo):
+//   FILA_SPSC_DEFINIR(Nome, Tipo, CAPACIDADE, Sufixo)
+//       uma thread produtora e uma consumidora, sem travas
+//
+// Funções geradas (com o Sufixo concatenado ao nome; use um sufixo vazio para
+// obter os nomes simples enfileirar, desenfileirar, filaVazia, ...):
+//   filaVazia, filaCheia, capacidadeFila, enfileirar, desenfileirar,
+//   verFrenteFila, enfileirarFrente, removerTrasFila, posicaoFila
+// VAZIO é o valor retornado quando se tenta remover de uma fila vazia.
+
+// Menor potência de dois maior ou igual a n (expressão constante, n <= 2^31)
+#define FILA__ESPALHAR1(x) ((x) | ((x) >> 1))
+#define FILA__ESPALHAR2(x) (FILA__ESPALHAR1(x) | (FILA__ESPALHAR1(x) >> 2))
+#define FILA__ESPALHAR4(x) (FILA__ESPALHAR2(x) | (FILA__ESPALHAR2(x) >> 4))
+#define FILA__ESPALHAR8(x) (FILA__ESPALHAR4(x) | (FILA__ESPALHAR4(x) >> 8))
+#define FILA__ESPALHAR16(x) (FILA__ESPALHAR8(x) | (FILA__ESPALHAR8(x) >> 16))
+#define FILA_ARMAZENAMENTO(n) (FILA__ESPALHAR16((unsigned) (n) - 1u) + 1u)
+
+// Versão em tempo de execução da mesma conta
+static inline unsigned filaArmazenamento(unsigned n) {
+    unsigned potencia = 1;
+    while (potencia < n) potencia <<= 1;
+    return potencia;
+}
+
+// Operações comuns às duas variantes. CAPACIDADE e MASCARA são expressões
+// avaliadas com a fila disponível em "fila".
+#define FILA__OPERACOES(Nome, Tipo, Sufixo, VAZIO, CAPACIDADE, MASCARA)                  \
+    static inline int filaVazia##Sufixo(const Nome *fila) {                               \
+        return fila->quantidade == 0;                                                     \
+    }                                                                                     \
+                                                                                          \
+    static inline int filaCheia##Sufixo(const Nome *fila) {                               \
+        return fila->quantidade == (int) (CAPACIDADE);                                    \
+    }                                                                                     \
+                                                                                          \
+    static inline int capacidadeFila##Sufixo(const Nome *fila) {                          \
+        (void) fila;                                                                      \
+        return (int) (CAPACIDADE);                                                        \
+    }                                                                                     \
+                                                                                          \
+    /* Ponteiro para o i-ésimo elemento a partir da frente (0 = frente) */                \
+    static inline Tipo *posicaoFila##Sufixo(Nome *fila, int i) {                          \
+        return &fila->itens[(unsigned) (fila->frente + i) & (MASCARA)];                   \
+    }                                                                                     \
+                                                                                          \
+    static inline void enfileirar##Sufixo(Nome *fila, Tipo item) {                        \
+        if (filaCheia##Sufixo(fila)) return;                                              \
+        *posicaoFila##Sufixo(fila, fila->quantidade) = item;                              \
+        fila->quantidade++;                                                               \
+    }                                                                                     \
+                                                                                          \
+    static inline Tipo desenfileirar##Sufixo(Nome *fila) {                                \
+        if (filaVazia##Sufixo(fila)) return VAZIO;                                        \
+        Tipo item = fila->itens[fila->frente];                                            \
+        fila->frente = (int) ((unsigned) (fila->frente + 1) & (MASCARA));                 \
+        fila->quantidade--;                                                               \
+        return item;                                                                      \
+    }                                                                                     \
+                                                                                          \
+    static inline Tipo verFrenteFila##Sufixo(Nome *fila) {                                \
+        if (filaVazia##Sufixo(fila)) return VAZIO;                                        \
+        return fila->itens[fila->frente];                                                 \
+    }                                                                                     \
+                                                                                          \
+    /* Insere na frente da fila (usado para desfazer ações) */                            \
+    static inline void enfileirarFrente##Sufixo(Nome *fila, Tipo item) {                  \
+        if (filaCheia##Sufixo(fila)) return;                                              \
+        fila->frente = (int) ((unsigned) (fila->frente - 1) & (MASCARA));                 \
+        fila->itens[fila->frente] = item;                                                 \
+        fila->quantidade++;                                                               \
+    }                                                                                     \
+                                                                                          \
+    /* Remove do fim da fila (usado para desfazer ações) */                               \
+    static inline Tipo removerTrasFila##Sufixo(Nome *fila) {                              \
+        if (filaVazia##Sufixo(fila)) return VAZIO;                                        \
+        fila->quantidade--;                                                               \
+        return *posicaoFila##Sufixo(fila, fila->quantidade);                              \
+    }
+
+// Fila com capacidade fixa em tempo de compilação
+#define FILA_DEFINIR(Nome, Tipo, CAPACIDADE, Sufixo, VAZIO)                               \
+    typedef struct {                                                                      \
+        Tipo itens[FILA_ARMAZENAMENTO(CAPACIDADE)];                                       \
+        int frente;                                                                       \
+        int quantidade;                                                                   \
+    } Nome;                                                                               \
+                                                                                          \
+    static inline void inicializarFilaVazia##Sufixo(Nome *fila) {                         \
+        fila->frente = 0;                                                                 \
+        fila->quantidade = 0;                                                             \
+    }                                                                                     \
+                                                                                          \
+    FILA__OPERACOES(Nome, Tipo, Sufixo, VAZIO, (CAPACIDADE),                              \
+                    FILA_ARMAZENAMENTO(CAPACIDADE) - 1u)
+
+// Fila com capacidade escolhida em tempo de execução
+#define FILA_DINAMICA_DEFINIR(Nome, Tipo, Sufixo, VAZIO)                                  \
+    typedef struct {                                                                      \
+        Tipo *itens;                                                                      \
+        unsigned mascara;                                                                 \
+        int capacidade;                                                                   \
+        int frente;                                                                       \
+        int quantidade;                                                                   \
+    } Nome;                                                                               \
+                                                                                          \
+    /* Retorna 1 em caso de sucesso e 0 se não houver memória */                          \
+    static inline int criarFila##Sufixo(Nome *fila, int capacidade) {                     \
+        unsigned armazenamento = filaArmazenamento(capacidade > 0 ? capacidade : 1);      \
+        fila->itens = malloc(armazenamento * sizeof(Tipo));                               \
+        fila->mascara = armazenamento - 1;                                                \
+        fila->capacidade = fila->itens != NULL ? capacidade : 0;                          \
+        fila->frente = 0;                                                                 \
+        fila->quantidade = 0;                                                             \
+        return fila->itens != NULL;                                                       \
+    }                                                                                     \
+                                                                                          \
+    static inline void liberarFila##Sufixo(Nome *fila) {                                  \
+        free(fila->itens);                                                                \
+        fila->itens = NULL;                                                               \
+        fila->capacidade = 0;                                                             \
+        fila->quantidade = 0;                                                             \
+    }                                                                                     \
+                                                                                          \
+    FILA__OPERACOES(Nome, Tipo, Sufixo, VAZIO, fila->capacidade, fila->mascara)
+
+// Fila circular sem travas para exatamente uma thread produtora e uma
+// consumidora (SPSC). O mesmo armazenamento potência de dois das outras
+// variantes, mas com contadores crescentes (cabeça = total já retirado,
+// cauda = total já inserido) em vez de frente e quantidade, e cada contador
+// na sua própria linha de cache para que as duas threads não disputem a mesma
+// linha. Cada lado também guarda a última cópia que leu do contador do outro
+// lado e só o relê quando essa cópia indica fila cheia (ou vazia).
+//
+// A capacidade é o próprio armazenamento (potência de dois).
+// Funções geradas: inicializarFilaSpsc, enfileirarSpsc, desenfileirarSpsc,
+// ocupacaoFilaSpsc (com o Sufixo concatenado). As duas primeiras de inserção e
+// retirada retornam 1 em caso de sucesso e 0 se a fila estava cheia/vazia.
+#define FILA_SPSC_DEFINIR(Nome, Tipo, CAPACIDADE, Sufixo)                                 \
+    typedef struct {                                                                      \
+        _Alignas(64) atomic_size_t cabeca;      /* escrita só pela consumidora */         \
+        size_t caudaConhecida;                  /* cópia da cauda, da consumidora */      \
+        _Alignas(64) atomic_size_t cauda;       /* escrita só pela produtora */           \
+        size_t cabecaConhecida;                 /* cópia da cabeça, da produtora */       \
+        _Alignas(64) Tipo itens[FILA_ARMAZENAMENTO(CAPACIDADE)];                          \
+    } Nome;                                                                               \
+                                                                                          \
+    static inline void inicializarFilaSpsc##Sufixo(Nome *fila) {                          \
+        atomic_init(&fila->cabeca, 0);                                                    \
+        atomic_init(&fila->cauda, 0);                                                     \
+        fila->caudaConhecida = 0;                                                         \
+        fila->cabecaConhecida = 0;                                                        \
+    }                                                                                     \
+                                                                                          \
+    /* Só a thread produtora chama */                                                     \
+    static inline int enfileirarSpsc##Sufixo(Nome *fila, Tipo item) {                     \
+        size_t cauda = atomic_load_explicit(&fila->cauda, memory_order_relaxed);          \
+        if (cauda - fila->cabecaConhecida == FILA_ARMAZENAMENTO(CAPACIDADE)) {            \
+            fila->cabecaConhecida = atomic_load_explicit(&fila->cabeca, memory_order_acquire); \
+            if (cauda - fila->cabecaConhecida == FILA_ARMAZENAMENTO(CAPACIDADE)) return 0; \
+        }                                                                                 \
+        fila->itens[cauda & (FILA_ARMAZENAMENTO(CAPACIDADE) - 1u)] = item;                \
+        atomic_store_explicit(&fila->cauda, cauda + 1, memory_order_release);             \
+        return 1;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    /* Só a thread consumidora chama */                                                   \
+    static inline int desenfileirarSpsc##Sufixo(Nome *fila, Tipo *item) {                 \
+        size_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_relaxed);        \
+        if (cabeca == fila->caudaConhecida) {                                             \
+            fila->caudaConhecida = atomic_load_explicit(&fila->cauda, memory_order_acquire); \
+            if (cabeca == fila->caudaConhecida) return 0;                                 \
+        }                                                                                 \
+        *item = fila->itens[cabeca & (FILA_ARMAZENAMENTO(CAPACIDADE) - 1u)];              \
+        atomic_store_explicit(&fila->cabeca, cabeca + 1, memory_order_release);           \
+        return 1;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    /* Aproximada quando chamada enquanto a outra thread trabalha */                      \
+    static inline size_t ocupacaoFilaSpsc##Sufixo(Nome *fila) {                           \
+        return atomic_load_explicit(&fila->cauda, memory_order_acquire) -                 \
+               atomic_load_explicit(&fila->cabeca, memory_order_acquire);                 \
+    }
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef FILAPECAS_H
+#define FILAPECAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fila.h"
+#include "peca.h"
+
+// Fila de peças em estrutura de vetores (SoA)
+// Para filas grandes (busca com muitas peças à frente, sequências longas do
+// gerador), tipos e ids ficam em vetores separados: os tipos ocupam um byte
+// por peça e podem ser percorridos de forma contígua, sem carregar os ids.
+// A interface é a mesma das filas de fila.h, com o sufixo "Pecas", e a
+// capacidade também é arredondada para uma potência de dois no armazenamento.
+
+typedef struct {
+    unsigned char *tipos;   // TipoPeca
+    uint32_t *ids;
+    unsigned mascara;
+    int capacidade;
+    int frente;
+    int quantidade;
+} FilaPecas;
+
+// Retorna 1 em caso de sucesso e 0 se não houver memória
+static inline int criarFilaPecas(FilaPecas *fila, int capacidade) {
+    unsigned armazenamento = filaArmazenamento(capacidade > 0 ? capacidade : 1);
+    fila->tipos = malloc(armazenamento);
+    fila->ids = malloc(armazenamento * sizeof(uint32_t));
+    if (fila->tipos == NULL || fila->ids == NULL) {
+        free(fila->tipos);
+        free(fila->ids);
+        fila->tipos = NULL;
+        fila->ids = NULL;
+        capacidade = 0;
+    }
+    fila->mascara = armazenamento - 1;
+    fila->capacidade = capacidade;
+    fila->frente = 0;
+    fila->quantidade = 0;
+    return fila->tipos != NULL;
+}
+
+static inline void liberarFilaPecas(FilaPecas *fila) {
+    free(fila->tipos);
+    free(fila->ids);
+    fila->tipos = NULL;
+    fila->ids = NULL;
+    fila->capacidade = 0;
+    fila->quantidade = 0;
+}
+
+static inline int filaVaziaPecas(const FilaPecas *fila) {
+    return fila->quantidade == 0;
+}
+
+static inline int filaCheiaPecas(const FilaPecas *fila) {
+    return fila->quantidade == fila->capacidade;
+}
+
+// Índice no armazenamento do i-ésimo elemento a partir da frente (0 = frente)
+static inline unsigned posicaoFilaPecas(const FilaPecas *fila, int i) {
+    return (unsigned) (fila->frente + i) & fila->mascara;
+}
+
+static inline Peca pecaFilaPecas(const FilaPecas *fila, int i) {
+    unsigned posicao = posicaoFilaPecas(fila, i);
+    return (Peca) {fila->tipos[posicao], fila->ids[posicao]};
+}
+
+static inline void enfileirarPecas(FilaPecas *fila, Peca peca) {
+    if (filaCheiaPecas(fila)) return;
+    unsigned posicao = posicaoFilaPecas(fila, fila->quantidade);
+    fila->tipos[posicao] = peca.tipo;
+    fila->ids[posicao] = peca.id;
+    fila->quantidade++;
+}
+
+static inline Peca desenfileirarPecas(FilaPecas *fila) {
+    if (filaVaziaPecas(fila)) return PECA_VAZIA;
+    Peca peca = pecaFilaPecas(fila, 0);
+    fila->frente = (int) ((unsigned) (fila->frente + 1) & fila->mascara);
+    fila->quantidade--;
+    return peca;
+}
+
+static inline Peca verFrenteFilaPecas(const FilaPecas *fila) {
+    if (filaVaziaPecas(fila)) return PECA_VAZIA;
+    return pecaFilaPecas(fila, 0);
+}
+
+// Tipos da fila como no máximo dois trechos contíguos (o segundo existe quando
+// a fila dá a volta no armazenamento), na ordem da frente para o fim
+static inline void trechosTiposFilaPecas(const FilaPecas *fila, const unsigned char **primeiro, size_t *tamanhoPrimeiro,
+                                         const unsigned char **segundo, size_t *tamanhoSegundo) {
+    size_t armazenamento = (size_t) fila->mascara + 1;
+    size_t ateOFim = armazenamento - (size_t) fila->frente;
+    size_t quantidade = (size_t) fila->quantidade;
+
+    *primeiro = fila->tipos + fila->frente;
+    *tamanhoPrimeiro = quantidade < ateOFim ? quantidade : ateOFim;
+    *segundo = fila->tipos;
+    *tamanhoSegundo = quantidade - *tamanhoPrimeiro;
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "formas.h"
+
+// As tabelas abaixo são geradas pelo compilador a partir de uma única
+// descrição de cada peça: a máscara da posição inicial dentro da caixa de
+// rotação do SRS (4x4 para o I, 2x2 para o O e 3x3 para as demais), com a
+// célula (x, y) no bit 4 * y + x e y = 0 na base da caixa. Todas as contas
+// são expressões constantes, então nada disso é executado em tempo de
+// execução.
+
+// Máscara de cada tipo na rotação 0 e o lado da sua caixa de rotação
+#define CAIXA_I 0x0F00, 4
+#define CAIXA_O 0x0033, 2
+#define CAIXA_T 0x0270, 3
+#define CAIXA_L 0x0470, 3
+#define CAIXA_J 0x0170, 3
+#define CAIXA_S 0x0630, 3
+#define CAIXA_Z 0x0360, 3
+
+// Destino da célula (x, y) após k giros horários numa caixa n x n
+#define GIRO_X(n, k, x, y) ((k) == 0 ? (x) : (k) == 1 ? (y) : (k) == 2 ? (n) - 1 - (x) : (n) - 1 - (y))
+#define GIRO_Y(n, k, x, y) ((k) == 0 ? (y) : (k) == 1 ? (n) - 1 - (x) : (k) == 2 ? (n) - 1 - (y) : (x))
+
+#define GIRAR_CELULA(m, n, k, x, y)                                                   \
+    ((x) < (n) && (y) < (n) && ((m) >> (4 * (y) + (x)) & 1)                           \
+         ? 1u << (4 * GIRO_Y(n, k, x, y) + GIRO_X(n, k, x, y)) : 0u)
+
+#define GIRAR_LINHA(m, n, k, y)                                                       \
+    (GIRAR_CELULA(m, n, k, 0, y) | GIRAR_CELULA(m, n, k, 1, y) |                      \
+     GIRAR_CELULA(m, n, k, 2, y) | GIRAR_CELULA(m, n, k, 3, y))
+
+#define GIRAR_CAIXA(m, n, k)                                                          \
+    (GIRAR_LINHA(m, n, k, 0) | GIRAR_LINHA(m, n, k, 1) |                              \
+     GIRAR_LINHA(m, n, k, 2) | GIRAR_LINHA(m, n, k, 3))
+
+// Máscaras de todas as rotações, como constantes nomeadas (CAIXA_T_1, ...)
+// para que as macros seguintes não precisem repetir a conta do giro
+#define GIRAR_TIPO(caixa, k) GIRAR_CAIXA(caixa, k)
+#define ROTACOES_CAIXA(T)                                                             \
+    CAIXA_##T##_0 = GIRAR_TIPO(CAIXA_##T, 0),                                         \
+    CAIXA_##T##_1 = GIRAR_TIPO(CAIXA_##T, 1),                                         \
+    CAIXA_##T##_2 = GIRAR_TIPO(CAIXA_##T, 2),                                         \
+    CAIXA_##T##_3 = GIRAR_TIPO(CAIXA_##T, 3)
+
+enum {
+    ROTACOES_CAIXA(I), ROTACOES_CAIXA(O), ROTACOES_CAIXA(T), ROTACOES_CAIXA(L),
+    ROTACOES_CAIXA(J), ROTACOES_CAIXA(S), ROTACOES_CAIXA(Z)
+};
+
+// Recorte de uma máscara para o menor retângulo que contém a peça
+#define LINHA_CAIXA(m, y) (((unsigned) (m) >> (4 * (y))) & 0xFu)
+#define COLUNAS_CAIXA(m) (LINHA_CAIXA(m, 0) | LINHA_CAIXA(m, 1) | LINHA_CAIXA(m, 2) | LINHA_CAIXA(m, 3))
+#define BASE_CAIXA(m) (LINHA_CAIXA(m, 0) ? 0 : LINHA_CAIXA(m, 1) ? 1 : LINHA_CAIXA(m, 2) ? 2 : 3)
+#define TOPO_CAIXA(m) (LINHA_CAIXA(m, 3) ? 3 : LINHA_CAIXA(m, 2) ? 2 : LINHA_CAIXA(m, 1) ? 1 : 0)
+#define ESQUERDA_CAIXA(m) (COLUNAS_CAIXA(m) & 1 ? 0 : COLUNAS_CAIXA(m) & 2 ? 1 : COLUNAS_CAIXA(m) & 4 ? 2 : 3)
+#define DIREITA_CAIXA(m) (COLUNAS_CAIXA(m) & 8 ? 3 : COLUNAS_CAIXA(m) & 4 ? 2 : COLUNAS_CAIXA(m) & 2 ? 1 : 0)
+
+#define FORMA_CAIXA(m)                                                                \
+    {{LINHA_CAIXA(m, BASE_CAIXA(m) + 0) >> ESQUERDA_CAIXA(m),                         \
+      LINHA_CAIXA(m, BASE_CAIXA(m) + 1) >> ESQUERDA_CAIXA(m),                         \
+      LINHA_CAIXA(m, BASE_CAIXA(m) + 2) >> ESQUERDA_CAIXA(m),                         \
+      LINHA_CAIXA(m, BASE_CAIXA(m) + 3) >> ESQUERDA_CAIXA(m)},                        \
+     DIREITA_CAIXA(m) - ESQUERDA_CAIXA(m) + 1,                                        \
+     TOPO_CAIXA(m) - BASE_CAIXA(m) + 1,                                               \
+     ESQUERDA_CAIXA(m),                                                               \
+     BASE_CAIXA(m)}
+
+#define FORMAS(T) \
+    {FORMA_CAIXA(CAIXA_##T##_0), FORMA_CAIXA(CAIXA_##T##_1), FORMA_CAIXA(CAIXA_##T##_2), FORMA_CAIXA(CAIXA_##T##_3)}
+
+const FormaPeca FORMAS_PECA[TOTAL_TIPOS_PECA + 1][TOTAL_ROTACOES] = {
+    [PECA_I] = FORMAS(I),
+    [PECA_O] = FORMAS(O),
+    [PECA_T] = FORMAS(T),
+    [PECA_L] = FORMAS(L),
+    [PECA_J] = FORMAS(J),
+    [PECA_S] = FORMAS(S),
+    [PECA_Z] = FORMAS(Z),
+    [PECA_NENHUMA] = {{{0}}}
+};
+
+// Testes de chute do SRS, por rotação de origem (0, R, 2, L) e sentido
+// (horário, anti-horário). O primeiro teste é sempre o giro sem deslocamento.
+#define CHUTES_JLSTZ                                                                  \
+    {{{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}},   /* 0 -> R */                  \
+      {{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},     /* 0 -> L */                  \
+     {{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}},       /* R -> 2 */                  \
+      {{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},      /* R -> 0 */                  \
+     {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}},      /* 2 -> L */                  \
+      {{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}},  /* 2 -> R */                  \
+     {{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}},    /* L -> 0 */                  \
+      {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}}}   /* L -> 2 */
+
+#define CHUTES_I                                                                      \
+    {{{{0, 0}, {-2, 0}, {1, 0}, {-2, -1}, {1, 2}},     /* 0 -> R */                  \
+      {{0, 0}, {-1, 0}, {2, 0}, {-1, 2}, {2, -1}}},    /* 0 -> L */                  \
+     {{{0, 0}, {-1, 0}, {2, 0}, {-1, 2}, {2, -1}},     /* R -> 2 */                  \
+      {{0, 0}, {2, 0}, {-1, 0}, {2, 1}, {-1, -2}}},    /* R -> 0 */                  \
+     {{{0, 0}, {2, 0}, {-1, 0}, {2, 1}, {-1, -2}},     /* 2 -> L */                  \
+      {{0, 0}, {1, 0}, {-2, 0}, {1, -2}, {-2, 1}}},    /* 2 -> R */                  \
+     {{{0, 0}, {1, 0}, {-2, 0}, {1, -2}, {-2, 1}},     /* L -> 0 */                  \
+      {{0, 0}, {-2, 0}, {1, 0}, {-2, -1}, {1, 2}}}}    /* L -> 2 */
+
+// O O não sai do lugar ao girar
+const Deslocamento CHUTES_PECA[TOTAL_TIPOS_PECA + 1][TOTAL_ROTACOES][2][TOTAL_TESTES_CHUTE] = {
+    [PECA_I] = CHUTES_I,
+    [PECA_O] = {{{{0}}}},
+    [PECA_T] = CHUTES_JLSTZ,
+    [PECA_L] = CHUTES_JLSTZ,
+    [PECA_J] = CHUTES_JLSTZ,
+    [PECA_S] = CHUTES_JLSTZ,
+    [PECA_Z] = CHUTES_JLSTZ,
+    [PECA_NENHUMA] = {{{{0}}}}
+};
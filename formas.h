@@ -0,0 +1,57 @@
+#ifndef FORMAS_H
+#define FORMAS_H
+
+#include <stdint.h>
+
+#include "peca.h"
+
+// Formas e chutes de parede das peças
+// As quatro rotações de cada tipo e os deslocamentos de chute do SRS (Super
+// Rotation System) ficam em tabelas constantes calculadas pelo compilador
+// (ver formas.c). Girar ou posicionar uma peça é só uma consulta indexada
+// pelo TipoPeca e pela rotação, sem nenhuma conta de rotação em tempo de
+// execução.
+
+#define TOTAL_ROTACOES 4
+#define TOTAL_TESTES_CHUTE 5
+
+// Sentido do giro
+typedef enum {
+    GIRO_HORARIO = 0,
+    GIRO_ANTI_HORARIO = 1
+} SentidoGiro;
+
+// Forma de uma peça: até 4 linhas de até 4 colunas, da linha de baixo para a
+// de cima, com a coluna mais à esquerda no bit 0. colunaCaixa e linhaCaixa
+// são a posição da forma dentro da caixa de rotação do SRS, usadas para que
+// o giro mantenha a peça no lugar.
+typedef struct {
+    uint8_t linhas[4];
+    uint8_t largura;
+    uint8_t altura;
+    uint8_t colunaCaixa;
+    uint8_t linhaCaixa;
+} FormaPeca;
+
+// Deslocamento de um teste de chute (linha positiva = para cima)
+typedef struct {
+    int8_t coluna;
+    int8_t linha;
+} Deslocamento;
+
+// FORMAS_PECA[tipo][rotacao]; a linha PECA_NENHUMA tem formas vazias
+extern const FormaPeca FORMAS_PECA[TOTAL_TIPOS_PECA + 1][TOTAL_ROTACOES];
+
+// CHUTES_PECA[tipo][rotacao de origem][sentido][teste]
+extern const Deslocamento CHUTES_PECA[TOTAL_TIPOS_PECA + 1][TOTAL_ROTACOES][2][TOTAL_TESTES_CHUTE];
+
+static inline const FormaPeca *formaPeca(TipoPeca tipo, int rotacao) {
+    return &FORMAS_PECA[tipo][rotacao & (TOTAL_ROTACOES - 1)];
+}
+
+// Rotação resultante de um giro no sentido dado
+static inline int rotacaoGirada(int rotacao, SentidoGiro sentido) {
+    return (rotacao + (sentido == GIRO_HORARIO ? 1 : TOTAL_ROTACOES - 1)) & (TOTAL_ROTACOES - 1);
+}
+
+#endif
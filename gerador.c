@@ -0,0 +1,137 @@
+#include <string.h>
+
+#include "gerador.h"
+
+static inline uint64_t rotacionar(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// SplitMix64: espalha a semente pelos 256 bits de estado do xoshiro
+static uint64_t splitMix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Função para inicializar o gerador com uma semente
+void inicializarGerador(GeradorPecas *gerador, uint64_t semente, ModoGerador modo) {
+    uint64_t x = semente;
+    for (int i = 0; i < 4; i++) {
+        gerador->estado[i] = splitMix64(&x);
+    }
+
+    gerador->semente = semente;
+    gerador->modo = modo;
+    gerador->proximoId = 1;
+    gerador->posicaoSaco = TOTAL_TIPOS_PECA;    // saco vazio: será embaralhado no primeiro uso
+}
+
+// xoshiro256**
+uint64_t proximoAleatorio(GeradorPecas *gerador) {
+    uint64_t *s = gerador->estado;
+    uint64_t resultado = rotacionar(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotacionar(s[3], 45);
+
+    return resultado;
+}
+
+// Número uniforme em [0, limite) sem viés (multiplicação com rejeição)
+uint32_t aleatorioAte(GeradorPecas *gerador, uint32_t limite) {
+    uint64_t produto = (proximoAleatorio(gerador) >> 32) * limite;
+    uint32_t resto = (uint32_t) produto;
+
+    if (resto < limite) {
+        uint32_t minimo = -limite % limite;
+        while (resto < minimo) {
+            produto = (proximoAleatorio(gerador) >> 32) * limite;
+            resto = (uint32_t) produto;
+        }
+    }
+
+    return (uint32_t) (produto >> 32);
+}
+
+// Embaralha um novo saco com os 7 tipos (Fisher-Yates)
+static void encherSaco(GeradorPecas *gerador) {
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        gerador->saco[i] = (unsigned char) i;
+    }
+
+    for (int i = TOTAL_TIPOS_PECA - 1; i > 0; i--) {
+        int j = aleatorioAte(gerador, i + 1);
+        unsigned char temp = gerador->saco[i];
+        gerador->saco[i] = gerador->saco[j];
+        gerador->saco[j] = temp;
+    }
+
+    gerador->posicaoSaco = 0;
+}
+
+// Função para gerar a próxima peça
+Peca proximaPeca(GeradorPecas *gerador) {
+    Peca novaPeca;
+    gerarLotePecas(gerador, &novaPeca, 1);
+    return novaPeca;
+}
+
+// Função para gerar várias peças de uma vez no buffer de destino
+void gerarLotePecas(GeradorPecas *gerador, Peca *destino, size_t quantidade) {
+    uint32_t id = gerador->proximoId;
+
+    if (gerador->modo == GERADOR_UNIFORME) {
+        for (size_t i = 0; i < quantidade; i++) {
+            destino[i].tipo = aleatorioAte(gerador, TOTAL_TIPOS_PECA);
+            destino[i].id = id++;
+        }
+    } else {
+        size_t i = 0;
+        while (i < quantidade) {
+            if (gerador->posicaoSaco == TOTAL_TIPOS_PECA) encherSaco(gerador);
+
+            // Copia o que restar do saco atual (ou só o necessário)
+            size_t restantes = TOTAL_TIPOS_PECA - gerador->posicaoSaco;
+            if (restantes > quantidade - i) restantes = quantidade - i;
+
+            const unsigned char *saco = &gerador->saco[gerador->posicaoSaco];
+            for (size_t k = 0; k < restantes; k++, i++) {
+                destino[i].tipo = saco[k];
+                destino[i].id = id++;
+            }
+            gerador->posicaoSaco += (int) restantes;
+        }
+    }
+
+    gerador->proximoId = id;
+}
+
+// Função para gerar só os tipos das próximas peças (um byte por peça), para
+// análises sobre sequências longas; os ids avançam como em gerarLotePecas
+void gerarLoteTipos(GeradorPecas *gerador, unsigned char *destino, size_t quantidade) {
+    if (gerador->modo == GERADOR_UNIFORME) {
+        for (size_t i = 0; i < quantidade; i++) {
+            destino[i] = (unsigned char) aleatorioAte(gerador, TOTAL_TIPOS_PECA);
+        }
+    } else {
+        size_t i = 0;
+        while (i < quantidade) {
+            if (gerador->posicaoSaco == TOTAL_TIPOS_PECA) encherSaco(gerador);
+
+            size_t restantes = TOTAL_TIPOS_PECA - gerador->posicaoSaco;
+            if (restantes > quantidade - i) restantes = quantidade - i;
+
+            memcpy(destino + i, &gerador->saco[gerador->posicaoSaco], restantes);
+            i += restantes;
+            gerador->posicaoSaco += (int) restantes;
+        }
+    }
+
+    gerador->proximoId += (uint32_t) quantidade;
+}
@@ -0,0 +1,37 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "peca.h"
+
+// Gerador de peças
+// Usa o xoshiro256** como gerador pseudoaleatório, com semente explícita: a
+// mesma semente sempre produz a mesma sequência de peças, o que permite
+// reproduzir partidas. Os ids são sequenciais, então nunca se repetem.
+
+// Forma de sortear o tipo das peças
+typedef enum {
+    GERADOR_SACO = 0,       // saco de 7: embaralha os 7 tipos e entrega um de cada
+    GERADOR_UNIFORME = 1    // cada peça sorteada de forma independente
+} ModoGerador;
+
+// Estado do gerador
+typedef struct {
+    uint64_t estado[4];
+    uint64_t semente;
+    ModoGerador modo;
+    uint32_t proximoId;
+    unsigned char saco[TOTAL_TIPOS_PECA];   // TipoPeca
+    int posicaoSaco;        // próxima posição do saco a ser entregue
+} GeradorPecas;
+
+void inicializarGerador(GeradorPecas *gerador, uint64_t semente, ModoGerador modo);
+uint64_t proximoAleatorio(GeradorPecas *gerador);
+uint32_t aleatorioAte(GeradorPecas *gerador, uint32_t limite);
+Peca proximaPeca(GeradorPecas *gerador);
+void gerarLotePecas(GeradorPecas *gerador, Peca *destino, size_t quantidade);
+void gerarLoteTipos(GeradorPecas *gerador, unsigned char *destino, size_t quantidade);
+
+#endif
@@ -0,0 +1,190 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gravacao.h"
+#include "relogio.h"
+
+static const unsigned char ASSINATURA[4] = {'T', 'T', 'R', 'G'};
+
+static void escreverU64(unsigned char *destino, uint64_t valor) {
+    for (int i = 0; i < 8; i++) destino[i] = (unsigned char) (valor >> (8 * i));
+}
+
+static uint64_t lerU64(const unsigned char *origem) {
+    uint64_t valor = 0;
+    for (int i = 0; i < 8; i++) valor |= (uint64_t) origem[i] << (8 * i);
+    return valor;
+}
+
+// Funções do gravador
+static int esvaziarBuffer(GravadorPartida *gravador) {
+    if (gravador->usado > 0 && fwrite(gravador->buffer, 1, gravador->usado, gravador->arquivo) != gravador->usado) {
+        gravador->erro = 1;
+    }
+    gravador->usado = 0;
+    return !gravador->erro;
+}
+
+// Função para criar o arquivo e gravar o cabeçalho
+// Retorna 1 em caso de sucesso e 0 se o arquivo não puder ser criado.
+int abrirGravacao(GravadorPartida *gravador, const char *caminho, const ConfiguracaoJogo *configuracao) {
+    gravador->arquivo = fopen(caminho, "wb");
+    if (gravador->arquivo == NULL) return 0;
+
+    // O buffer do FILE seria redundante com o nosso
+    setvbuf(gravador->arquivo, NULL, _IONBF, 0);
+
+    unsigned char *cabecalho = gravador->buffer;
+    memcpy(cabecalho, ASSINATURA, sizeof(ASSINATURA));
+    cabecalho[4] = GRAVACAO_VERSAO;
+    cabecalho[5] = GRAVACAO_BITS_ACAO;
+    cabecalho[6] = (unsigned char) configuracao->largura;
+    cabecalho[7] = (unsigned char) configuracao->altura;
+    escreverU64(cabecalho + 8, configuracao->semente);
+    // Capacidade 0 vira 1, como em inicializarHistorico
+    escreverU64(cabecalho + 16, configuracao->capacidadeHistorico > 0 ? configuracao->capacidadeHistorico : 1);
+
+    gravador->usado = GRAVACAO_TAMANHO_CABECALHO;
+    gravador->inicioNs = relogioNs();
+    gravador->ultimoUs = 0;
+    gravador->acoes = 0;
+    gravador->erro = 0;
+    return 1;
+}
+
+// Grava uma ação feita no instante dado (relógio de relogioNs)
+// Ações que não mudam o estado (sair, visualizar) não são gravadas.
+int gravarAcao(GravadorPartida *gravador, AcaoJogo acao, int64_t instanteNs) {
+    if (acao == ACAO_SAIR || acao == ACAO_VISUALIZAR_HISTORICO || (unsigned) acao >= TOTAL_ACOES) return 1;
+
+    // Um varint de 64 bits ocupa no máximo 10 bytes
+    if (gravador->usado + 10 > GRAVACAO_BUFFER && !esvaziarBuffer(gravador)) return 0;
+
+    int64_t instanteUs = (instanteNs - gravador->inicioNs) / 1000;
+    uint64_t intervalo = instanteUs > gravador->ultimoUs ? (uint64_t) (instanteUs - gravador->ultimoUs) : 0;
+    uint64_t valor = intervalo << GRAVACAO_BITS_ACAO | (uint64_t) acao;
+    gravador->ultimoUs += (int64_t) intervalo;
+
+    unsigned char *destino = gravador->buffer + gravador->usado;
+    while (valor >= 0x80) {
+        *destino++ = (unsigned char) (valor | 0x80);
+        valor >>= 7;
+    }
+    *destino++ = (unsigned char) valor;
+
+    gravador->usado = destino - gravador->buffer;
+    gravador->acoes++;
+    return 1;
+}
+
+// Observador para o motor (EstadoJogo.observador): grava cada ação aplicada
+void gravarAoExecutar(void *gravador, AcaoJogo acao) {
+    gravarAcao(gravador, acao, relogioNs());
+}
+
+// Retorna 1 se tudo foi gravado sem erros
+int fecharGravacao(GravadorPartida *gravador) {
+    esvaziarBuffer(gravador);
+    if (fclose(gravador->arquivo) != 0) gravador->erro = 1;
+    gravador->arquivo = NULL;
+    return !gravador->erro;
+}
+
+// Funções do leitor
+// Função para mapear o arquivo e validar o cabeçalho
+// Retorna 1 em caso de sucesso e 0 se o arquivo não existe ou não é uma gravação.
+int abrirLeitura(LeitorPartida *leitor, const char *caminho) {
+    memset(leitor, 0, sizeof(*leitor));
+
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return 0;
+
+    struct stat informacoes;
+    if (fstat(descritor, &informacoes) != 0 || informacoes.st_size < GRAVACAO_TAMANHO_CABECALHO) {
+        close(descritor);
+        return 0;
+    }
+
+    void *dados = mmap(NULL, informacoes.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (dados == MAP_FAILED) return 0;
+    madvise(dados, informacoes.st_size, MADV_SEQUENTIAL);
+
+    leitor->dados = dados;
+    leitor->tamanho = informacoes.st_size;
+
+    const unsigned char *cabecalho = leitor->dados;
+    uint64_t capacidadeHistorico = lerU64(cabecalho + 16);
+    if (memcmp(cabecalho, ASSINATURA, sizeof(ASSINATURA)) != 0 || cabecalho[4] != GRAVACAO_VERSAO ||
+        cabecalho[5] != GRAVACAO_BITS_ACAO || capacidadeHistorico == 0 ||
+        capacidadeHistorico > HISTORICO_CAPACIDADE_MAXIMA) {
+        fecharLeitura(leitor);
+        return 0;
+    }
+
+    leitor->configuracao.largura = cabecalho[6];
+    leitor->configuracao.altura = cabecalho[7];
+    leitor->configuracao.semente = lerU64(cabecalho + 8);
+    leitor->configuracao.capacidadeHistorico = (size_t) capacidadeHistorico;
+    leitor->posicao = GRAVACAO_TAMANHO_CABECALHO;
+    return 1;
+}
+
+// Lê a próxima ação
+// Retorna 1 se leu, 0 no fim do arquivo e -1 se o arquivo está corrompido.
+int lerAcao(LeitorPartida *leitor, AcaoJogo *acao) {
+    if (leitor->posicao >= leitor->tamanho) return 0;
+
+    const unsigned char *origem = leitor->dados + leitor->posicao;
+    const unsigned char *fim = leitor->dados + leitor->tamanho;
+    uint64_t valor;
+
+    // Caminho rápido: um byte (ação no mesmo microssegundo da anterior ou logo depois)
+    if (*origem < 0x80) {
+        valor = *origem++;
+    } else {
+        valor = 0;
+        for (int deslocamento = 0;; deslocamento += 7) {
+            if (origem == fim || deslocamento > 63) {
+                leitor->corrompido = 1;
+                return -1;
+            }
+            unsigned char byte = *origem++;
+            valor |= (uint64_t) (byte & 0x7F) << deslocamento;
+            if (byte < 0x80) break;
+        }
+    }
+
+    unsigned codigo = (unsigned) (valor & ((1u << GRAVACAO_BITS_ACAO) - 1));
+    if (codigo >= TOTAL_ACOES) {
+        leitor->corrompido = 1;
+        return -1;
+    }
+
+    *acao = (AcaoJogo) codigo;
+    leitor->instanteUs += (int64_t) (valor >> GRAVACAO_BITS_ACAO);
+    leitor->posicao = origem - leitor->dados;
+    return 1;
+}
+
+// Reproduz no motor, sem pausas, todas as ações restantes da gravação
+// Retorna quantas ações foram lidas.
+size_t reproduzirPartida(LeitorPartida *leitor, EstadoJogo *estado) {
+    size_t lidas = 0;
+    AcaoJogo acao;
+
+    while (lerAcao(leitor, &acao) > 0) {
+        executarAcao(estado, acao);
+        lidas++;
+    }
+    return lidas;
+}
+
+void fecharLeitura(LeitorPartida *leitor) {
+    if (leitor->dados != NULL) munmap((void *) leitor->dados, leitor->tamanho);
+    leitor->dados = NULL;
+    leitor->tamanho = 0;
+}
@@ -0,0 +1,64 @@
+#ifndef GRAVACAO_H
+#define GRAVACAO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "motor.h"
+
+// Gravação e reprodução de partidas
+// Formato binário compacto (números em little-endian):
+//
+//   cabeçalho de 24 bytes
+//     0  "TTRG"               assinatura
+//     4  versão (1 byte)
+//     5  bits da ação (1 byte, hoje 5)
+//     6  largura, altura      (1 byte cada)
+//     8  semente              (8 bytes)
+//     16 capacidade do histórico (8 bytes)
+//   uma ação por registro, até o fim do arquivo
+//     varint de (microssegundos desde a ação anterior << 5) | código da ação
+//
+// Como as peças vêm do gerador com a semente do cabeçalho, as ações bastam
+// para refazer a partida inteira. Uma ação feita no mesmo microssegundo da
+// anterior ocupa um único byte.
+
+#define GRAVACAO_VERSAO 1
+#define GRAVACAO_BITS_ACAO 5
+#define GRAVACAO_TAMANHO_CABECALHO 24
+#define GRAVACAO_BUFFER (1 << 16)
+
+// Gravador com buffer próprio: as ações são codificadas direto no buffer e
+// só vão para o arquivo quando ele enche
+typedef struct {
+    FILE *arquivo;
+    unsigned char buffer[GRAVACAO_BUFFER];
+    size_t usado;
+    int64_t inicioNs;
+    int64_t ultimoUs;           // instante da ação anterior, desde o início
+    long acoes;
+    int erro;
+} GravadorPartida;
+
+// Leitor sobre o arquivo mapeado em memória
+typedef struct {
+    const unsigned char *dados;
+    size_t tamanho;
+    size_t posicao;
+    ConfiguracaoJogo configuracao;
+    int64_t instanteUs;         // instante da última ação lida, desde o início
+    int corrompido;
+} LeitorPartida;
+
+int abrirGravacao(GravadorPartida *gravador, const char *caminho, const ConfiguracaoJogo *configuracao);
+int gravarAcao(GravadorPartida *gravador, AcaoJogo acao, int64_t instanteNs);
+int fecharGravacao(GravadorPartida *gravador);
+void gravarAoExecutar(void *gravador, AcaoJogo acao);
+
+int abrirLeitura(LeitorPartida *leitor, const char *caminho);
+int lerAcao(LeitorPartida *leitor, AcaoJogo *acao);
+size_t reproduzirPartida(LeitorPartida *leitor, EstadoJogo *estado);
+void fecharLeitura(LeitorPartida *leitor);
+
+#endif
@@ -0,0 +1,517 @@
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ia.h"
+#include "relogio.h"
+
+// Pesos publicados para esta mesma heurística de quatro termos
+ConfiguracaoIa configuracaoIaPadrao(void) {
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    ConfiguracaoIa configuracao = {
+        processadores > 0 ? (int) processadores : 1,
+        3,
+        50.0,
+        32,
+        {-0.510066, 0.760666, -0.35663, -0.184483}
+    };
+    return configuracao;
+}
+
+// Funções do estado de busca
+static void montarRaiz(NoBusca *no, const EstadoJogo *estado) {
+    no->tabuleiro = estado->tabuleiro;
+
+    no->quantidadeFila = estado->fila.quantidade;
+    for (int i = 0; i < no->quantidadeFila; i++) {
+        no->fila[i] = posicaoFila((FilaCircular *) &estado->fila, i)->tipo;
+    }
+
+    no->quantidadePilha = estado->pilha.quantidade;
+    for (int i = 0; i < no->quantidadePilha; i++) {
+        no->pilha[i] = estado->pilha.pecas[i].tipo;
+    }
+}
+
+static unsigned char retirarFrente(NoBusca *no) {
+    unsigned char tipo = no->fila[0];
+    no->quantidadeFila--;
+    memmove(no->fila, no->fila + 1, no->quantidadeFila);
+    return tipo;
+}
+
+// Rotações que geram formas diferentes, como máscara de bits por tipo
+// (O tem 1, I, S e Z têm 2, as demais 4)
+static const unsigned char ROTACOES_DISTINTAS[TOTAL_TIPOS_PECA + 1] = {
+    [PECA_I] = 0x3, [PECA_O] = 0x1, [PECA_T] = 0xF, [PECA_L] = 0xF,
+    [PECA_J] = 0xF, [PECA_S] = 0x3, [PECA_Z] = 0x3, [PECA_NENHUMA] = 0
+};
+
+static int gerarColocacoes(const NoBusca *no, TipoLance tipoLance, TipoPeca peca, Lance *lances) {
+    int total = 0;
+    for (int r = 0; r < TOTAL_ROTACOES; r++) {
+        if (!(ROTACOES_DISTINTAS[peca] & (1u << r))) continue;
+
+        int maxima = no->tabuleiro.largura - formaPeca(peca, r)->largura;
+        for (int c = 0; c <= maxima; c++) {
+            lances[total].tipo = (unsigned char) tipoLance;
+            lances[total].rotacao = (unsigned char) r;
+            lances[total].coluna = (signed char) c;
+            total++;
+        }
+    }
+    return total;
+}
+
+// Enumera os lances possíveis a partir de um nó
+static int gerarLances(const NoBusca *no, Lance *lances) {
+    int total = 0;
+    int temFila = no->quantidadeFila > 0;
+    int temPilha = no->quantidadePilha > 0;
+    unsigned char frente = temFila ? no->fila[0] : PECA_NENHUMA;
+    unsigned char topo = temPilha ? no->pilha[no->quantidadePilha - 1] : PECA_NENHUMA;
+
+    if (temFila) {
+        total += gerarColocacoes(no, LANCE_JOGAR, frente, lances + total);
+    }
+    if (temPilha) {
+        total += gerarColocacoes(no, LANCE_USAR_RESERVA, topo, lances + total);
+    }
+    // Trocar peças do mesmo tipo e jogar é igual a jogar direto
+    if (temFila && temPilha && frente != topo) {
+        total += gerarColocacoes(no, LANCE_TROCAR_E_JOGAR, topo, lances + total);
+    }
+    if (temFila && no->quantidadePilha < TAMANHO_PILHA) {
+        lances[total].tipo = LANCE_RESERVAR;
+        lances[total].rotacao = 0;
+        lances[total].coluna = 0;
+        total++;
+    }
+    return total;
+}
+
+// Duas rotações com a mesma forma (ex.: a I deitada em 0 e em 2) dão as mesmas colocações
+static int mesmaForma(TipoPeca peca, int a, int b) {
+    const FormaPeca *x = formaPeca(peca, a);
+    const FormaPeca *y = formaPeca(peca, b);
+    return x->largura == y->largura && x->altura == y->altura && memcmp(x->linhas, y->linhas, sizeof(x->linhas)) == 0;
+}
+
+// Deixa na raiz só os lances cuja rotação o motor alcança com ACAO_GIRAR. O giro
+// sempre usa a peça da frente da fila, que, no LANCE_USAR_RESERVA, não é a peça
+// jogada; os chutes (e se o giro cabe) dependem dela. Uma rotação inalcançável
+// com a mesma forma de uma alcançável é trocada por esta.
+// Retorna quantos lances sobraram.
+static int filtrarLancesAlcancaveis(const NoBusca *raiz, const EstadoJogo *estado, Lance *lances, int total) {
+    TipoPeca frente = raiz->quantidadeFila > 0 ? (TipoPeca) raiz->fila[0] : PECA_NENHUMA;
+    TipoPeca topo = raiz->quantidadePilha > 0 ? (TipoPeca) raiz->pilha[raiz->quantidadePilha - 1] : PECA_NENHUMA;
+
+    // Depois da troca, a peça da frente (a que gira) é a que estava no topo
+    unsigned giroFrente = frente != PECA_NENHUMA ? rotacoesAlcancaveis(estado, frente) : 1u << estado->rotacaoMira;
+    unsigned giroTopo = topo != PECA_NENHUMA ? rotacoesAlcancaveis(estado, topo) : 0;
+
+    int mantidos = 0;
+    for (int i = 0; i < total; i++) {
+        Lance lance = lances[i];
+        if (lance.tipo == LANCE_JOGAR || lance.tipo == LANCE_USAR_RESERVA || lance.tipo == LANCE_TROCAR_E_JOGAR) {
+            unsigned alcancaveis = lance.tipo == LANCE_TROCAR_E_JOGAR ? giroTopo : giroFrente;
+            TipoPeca peca = lance.tipo == LANCE_JOGAR ? frente : topo;
+
+            if (!(alcancaveis & (1u << lance.rotacao))) {
+                int r = 0;
+                while (r < TOTAL_ROTACOES && !((alcancaveis & (1u << r)) && mesmaForma(peca, r, lance.rotacao))) r++;
+                if (r == TOTAL_ROTACOES) continue;
+                lance.rotacao = (unsigned char) r;
+            }
+        }
+        lances[mantidos++] = lance;
+    }
+    return mantidos;
+}
+
+// Aplica um lance em "destino" (cópia de "origem"), atualizando a chave de
+// Zobrist do tabuleiro quando "chaves" não é NULL
+// Retorna o número de linhas removidas, ou -1 se a peça não cabe.
+static int aplicarNoNo(const NoBusca *origem, Lance lance, NoBusca *destino, const ChavesZobrist *chaves) {
+    *destino = *origem;
+
+    unsigned char peca;
+    switch (lance.tipo) {
+        case LANCE_JOGAR:
+            peca = retirarFrente(destino);
+            break;
+        case LANCE_USAR_RESERVA:
+            peca = destino->pilha[--destino->quantidadePilha];
+            break;
+        case LANCE_TROCAR_E_JOGAR:
+            peca = destino->pilha[destino->quantidadePilha - 1];
+            destino->pilha[destino->quantidadePilha - 1] = retirarFrente(destino);
+            break;
+        default:
+            destino->pilha[destino->quantidadePilha++] = retirarFrente(destino);
+            return 0;
+    }
+
+    Jogada jogada;
+    const FormaPeca *forma = formaPeca(peca, lance.rotacao);
+    if (!soltarPeca(&destino->tabuleiro, forma, lance.coluna, &jogada)) return -1;
+
+    // Sem linhas removidas só as células da peça mudaram
+    if (chaves != NULL) {
+        destino->chave = jogada.linhasLimpas ? chaveTabuleiro(chaves, &destino->tabuleiro)
+                                             : destino->chave ^ chaveForma(chaves, forma, jogada.coluna, jogada.linha);
+    }
+    return __builtin_popcount(jogada.linhasLimpas);
+}
+
+// Heurística: alturas, buracos e irregularidade numa passada de cima para baixo
+// (as linhas removidas são somadas por quem aplica cada lance)
+static double avaliarTabuleiro(const Tabuleiro *tabuleiro, const PesosIa *pesos) {
+    int alturas[LARGURA_MAXIMA] = {0};
+    uint32_t cobertas = 0;      // colunas que já têm algum bloco acima
+    int buracos = 0;
+
+    for (int r = tabuleiro->altura - 1; r >= 0; r--) {
+        uint32_t linha = tabuleiro->linhas[r];
+        uint32_t novas = linha & ~cobertas;
+        while (novas) {
+            alturas[__builtin_ctz(novas)] = r + 1;
+            novas &= novas - 1;
+        }
+        buracos += __builtin_popcount(~linha & cobertas & tabuleiro->linhaCheia);
+        cobertas |= linha;
+    }
+
+    int alturaAgregada = alturas[0];
+    int irregularidade = 0;
+    for (int c = 1; c < tabuleiro->largura; c++) {
+        alturaAgregada += alturas[c];
+        irregularidade += alturas[c] > alturas[c - 1] ? alturas[c] - alturas[c - 1] : alturas[c - 1] - alturas[c];
+    }
+
+    return pesos->alturaAgregada * alturaAgregada + pesos->buracos * buracos +
+           pesos->irregularidade * irregularidade;
+}
+
+// Pontuação que não pode ser escolhida (a peça não cabe)
+#define PONTUACAO_PERDIDA -1e30
+
+// Chave completa de um nó: tabuleiro, fila, pilha e profundidade restante
+static uint64_t chaveNo(const ChavesZobrist *chaves, const NoBusca *no, int profundidade) {
+    uint64_t chave = no->chave ^ chaves->profundidade[profundidade];
+    for (int i = 0; i < no->quantidadeFila; i++) {
+        chave ^= chaves->fila[i][no->fila[i]];
+    }
+    for (int i = 0; i < no->quantidadePilha; i++) {
+        chave ^= chaves->pilha[i][no->pilha[i]];
+    }
+    return chave;
+}
+
+// Busca em profundidade: melhor pontuação alcançável a partir do nó, sem
+// contar as linhas removidas antes de chegar a ele
+static double buscar(TrabalhadorIa *trabalhador, const NoBusca *no, int profundidade) {
+    Ia *ia = trabalhador->ia;
+    const PesosIa *pesos = &ia->configuracao.pesos;
+    const ChavesZobrist *chaves = ia->usarTabela ? &ia->tabela.chaves : NULL;
+
+    trabalhador->nos++;
+    if ((trabalhador->nos & 255) == 0 && relogioNs() > ia->prazoNs) {
+        atomic_store_explicit(&ia->esgotado, 1, memory_order_relaxed);
+    }
+    if (profundidade == 0) return avaliarTabuleiro(&no->tabuleiro, pesos);
+
+    uint64_t chave = 0;
+    if (chaves != NULL) {
+        float guardado;
+        chave = chaveNo(chaves, no, profundidade);
+        trabalhador->consultas++;
+        if (consultarTransposicao(&ia->tabela, chave, &guardado)) {
+            trabalhador->acertos++;
+            return guardado;
+        }
+    }
+
+    // A lista é gerada no espaço máximo da arena e encolhida para o que foi
+    // usado, de modo que os níveis mais fundos fiquem logo em seguida
+    Arena *rascunho = &trabalhador->rascunho;
+    size_t marca = marcaArena(rascunho);
+    Lance *lances = alocarArena(rascunho, IA_MAX_LANCES * sizeof(Lance), _Alignof(Lance));
+    if (lances == NULL) return avaliarTabuleiro(&no->tabuleiro, pesos);
+
+    int total = gerarLances(no, lances);
+    voltarArena(rascunho, (size_t) ((unsigned char *) (lances + total) - rascunho->memoria));
+    if (total == 0) {
+        voltarArena(rascunho, marca);
+        return avaliarTabuleiro(&no->tabuleiro, pesos);
+    }
+
+    double melhor = PONTUACAO_PERDIDA;
+    for (int i = 0; i < total; i++) {
+        if (atomic_load_explicit(&ia->esgotado, memory_order_relaxed)) break;
+
+        NoBusca filho;
+        int removidas = aplicarNoNo(no, lances[i], &filho, chaves);
+        if (removidas < 0) continue;
+
+        double pontuacao = pesos->linhas * removidas + buscar(trabalhador, &filho, profundidade - 1);
+        if (pontuacao > melhor) melhor = pontuacao;
+    }
+    voltarArena(rascunho, marca);
+
+    // Um valor interrompido pelo prazo não é exato e não pode ser guardado
+    if (chaves != NULL && !atomic_load_explicit(&ia->esgotado, memory_order_relaxed)) {
+        trabalhador->substituicoes += gravarTransposicao(&ia->tabela, chave, (float) melhor, profundidade);
+    }
+    return melhor;
+}
+
+// Funções da fila de tarefas de cada thread
+static int retirarTarefaPropria(TrabalhadorIa *trabalhador) {
+    int tarefa = -1;
+    pthread_mutex_lock(&trabalhador->trava);
+    if (trabalhador->fim > trabalhador->inicio) tarefa = trabalhador->tarefas[--trabalhador->fim];
+    pthread_mutex_unlock(&trabalhador->trava);
+    return tarefa;
+}
+
+static int roubarTarefa(TrabalhadorIa *vitima) {
+    int tarefa = -1;
+    pthread_mutex_lock(&vitima->trava);
+    if (vitima->fim > vitima->inicio) tarefa = vitima->tarefas[vitima->inicio++];
+    pthread_mutex_unlock(&vitima->trava);
+    return tarefa;
+}
+
+static void executarTarefa(TrabalhadorIa *trabalhador, int tarefa) {
+    Ia *ia = trabalhador->ia;
+    NoBusca filho;
+
+    int removidas = aplicarNoNo(&ia->raiz, ia->lances[tarefa], &filho, ia->usarTabela ? &ia->tabela.chaves : NULL);
+    ia->pontuacoes[tarefa] = removidas < 0 ? PONTUACAO_PERDIDA
+                                           : ia->configuracao.pesos.linhas * removidas +
+                                             buscar(trabalhador, &filho, ia->profundidade - 1);
+}
+
+// Esvazia a própria fila e depois rouba das outras até não sobrar nada.
+// As tarefas não criam novas tarefas, então filas vazias significam o fim da rodada.
+static void trabalhar(TrabalhadorIa *trabalhador) {
+    Ia *ia = trabalhador->ia;
+    int threads = ia->configuracao.threads;
+    int tarefa;
+
+    while ((tarefa = retirarTarefaPropria(trabalhador)) >= 0) {
+        executarTarefa(trabalhador, tarefa);
+    }
+
+    for (int passo = 1; passo < threads; passo++) {
+        TrabalhadorIa *vitima = &ia->trabalhadores[(trabalhador->indice + passo) % threads];
+        while ((tarefa = roubarTarefa(vitima)) >= 0) {
+            trabalhador->roubos++;
+            executarTarefa(trabalhador, tarefa);
+        }
+    }
+}
+
+static void *cicloTrabalhador(void *argumento) {
+    TrabalhadorIa *trabalhador = argumento;
+    Ia *ia = trabalhador->ia;
+    unsigned long vista = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&ia->trava);
+        while (ia->rodada == vista && !ia->encerrar) {
+            pthread_cond_wait(&ia->inicioRodada, &ia->trava);
+        }
+        if (ia->encerrar) {
+            pthread_mutex_unlock(&ia->trava);
+            return NULL;
+        }
+        vista = ia->rodada;
+        pthread_mutex_unlock(&ia->trava);
+
+        trabalhar(trabalhador);
+
+        pthread_mutex_lock(&ia->trava);
+        if (--ia->ocupados == 0) pthread_cond_signal(&ia->fimRodada);
+        pthread_mutex_unlock(&ia->trava);
+    }
+}
+
+// Função para iniciar o bot e o seu conjunto de threads
+// Retorna 1 em caso de sucesso e 0 se as threads não puderem ser criadas.
+int iniciarIa(Ia *ia, const ConfiguracaoIa *configuracao) {
+    memset(ia, 0, sizeof(*ia));
+    ia->configuracao = *configuracao;
+    if (ia->configuracao.threads < 1) ia->configuracao.threads = 1;
+    if (ia->configuracao.threads > IA_MAX_THREADS) ia->configuracao.threads = IA_MAX_THREADS;
+    if (ia->configuracao.profundidade < 1) ia->configuracao.profundidade = 1;
+
+    // Sem memória para a tabela o bot continua funcionando, só que sem ela
+    ia->usarTabela = ia->configuracao.megabytesTabela > 0 &&
+                     criarTabelaTransposicao(&ia->tabela, ia->configuracao.megabytesTabela);
+
+    pthread_mutex_init(&ia->trava, NULL);
+    pthread_cond_init(&ia->inicioRodada, NULL);
+    pthread_cond_init(&ia->fimRodada, NULL);
+
+    // Cada nível abaixo da raiz guarda no máximo uma lista de lances, e a
+    // profundidade nunca passa do número de peças conhecidas
+    int niveis = ia->configuracao.profundidade < TAMANHO_FILA + TAMANHO_PILHA ? ia->configuracao.profundidade
+                                                                           : TAMANHO_FILA + TAMANHO_PILHA;
+    size_t bytesRascunho = (size_t) niveis * IA_MAX_LANCES * sizeof(Lance);
+
+    // A thread 0 é a que chama decidirLance; as demais ficam esperando rodadas
+    for (int i = 0; i < ia->configuracao.threads; i++) {
+        TrabalhadorIa *trabalhador = &ia->trabalhadores[i];
+        trabalhador->ia = ia;
+        trabalhador->indice = i;
+        pthread_mutex_init(&trabalhador->trava, NULL);
+
+        if (!criarArena(&trabalhador->rascunho, bytesRascunho) ||
+            (i > 0 && pthread_create(&trabalhador->thread, NULL, cicloTrabalhador, trabalhador) != 0)) {
+            liberarArena(&trabalhador->rascunho);
+            pthread_mutex_destroy(&trabalhador->trava);
+            ia->configuracao.threads = i;
+            encerrarIa(ia);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void encerrarIa(Ia *ia) {
+    pthread_mutex_lock(&ia->trava);
+    ia->encerrar = 1;
+    pthread_cond_broadcast(&ia->inicioRodada);
+    pthread_mutex_unlock(&ia->trava);
+
+    for (int i = 0; i < ia->configuracao.threads; i++) {
+        if (i > 0) pthread_join(ia->trabalhadores[i].thread, NULL);
+        pthread_mutex_destroy(&ia->trabalhadores[i].trava);
+        liberarArena(&ia->trabalhadores[i].rascunho);
+    }
+    pthread_mutex_destroy(&ia->trava);
+    pthread_cond_destroy(&ia->inicioRodada);
+    pthread_cond_destroy(&ia->fimRodada);
+    if (ia->usarTabela) liberarTabelaTransposicao(&ia->tabela);
+}
+
+// Executa uma rodada completa da busca na profundidade dada
+// Retorna 1 se ela terminou antes de o orçamento se esgotar.
+static int executarRodada(Ia *ia, int profundidade, int64_t prazoNs) {
+    int threads = ia->configuracao.threads;
+
+    ia->profundidade = profundidade;
+    ia->prazoNs = prazoNs;
+    atomic_store(&ia->esgotado, 0);
+
+    // Distribui as tarefas em rodízio pelas filas das threads
+    for (int t = 0; t < threads; t++) {
+        ia->trabalhadores[t].inicio = 0;
+        ia->trabalhadores[t].fim = 0;
+    }
+    for (int i = 0; i < ia->totalLances; i++) {
+        TrabalhadorIa *dona = &ia->trabalhadores[i % threads];
+        dona->tarefas[dona->fim++] = i;
+    }
+
+    pthread_mutex_lock(&ia->trava);
+    ia->rodada++;
+    ia->ocupados = threads - 1;
+    pthread_cond_broadcast(&ia->inicioRodada);
+    pthread_mutex_unlock(&ia->trava);
+
+    trabalhar(&ia->trabalhadores[0]);
+
+    pthread_mutex_lock(&ia->trava);
+    while (ia->ocupados > 0) {
+        pthread_cond_wait(&ia->fimRodada, &ia->trava);
+    }
+    pthread_mutex_unlock(&ia->trava);
+
+    return !atomic_load(&ia->esgotado);
+}
+
+// Função para escolher o lance da vez
+// A profundidade 1 sempre é concluída; as seguintes só valem se terminarem no prazo.
+DecisaoIa decidirLance(Ia *ia, const EstadoJogo *estado) {
+    DecisaoIa decisao = {{LANCE_NENHUM, 0, 0}, PONTUACAO_PERDIDA, 0, 0, 0, 0, 0, 0, 0, 0};
+    int64_t inicio = relogioNs();
+    int64_t prazo = inicio + (int64_t) (ia->configuracao.orcamentoMs * 1e6);
+
+    montarRaiz(&ia->raiz, estado);
+    if (ia->usarTabela) {
+        ia->raiz.chave = chaveTabuleiro(&ia->tabela.chaves, &ia->raiz.tabuleiro);
+        novaGeracaoTransposicao(&ia->tabela);
+    }
+    ia->totalLances = filtrarLancesAlcancaveis(&ia->raiz, estado, ia->lances, gerarLances(&ia->raiz, ia->lances));
+
+    for (int t = 0; t < ia->configuracao.threads; t++) {
+        TrabalhadorIa *trabalhador = &ia->trabalhadores[t];
+        trabalhador->nos = trabalhador->roubos = 0;
+        trabalhador->consultas = trabalhador->acertos = trabalhador->substituicoes = 0;
+        reiniciarArena(&trabalhador->rascunho);
+        trabalhador->rascunho.pico = 0;
+    }
+
+    int pecasConhecidas = ia->raiz.quantidadeFila + ia->raiz.quantidadePilha;
+    int maxima = ia->configuracao.profundidade < pecasConhecidas ? ia->configuracao.profundidade : pecasConhecidas;
+
+    for (int profundidade = 1; profundidade <= maxima; profundidade++) {
+        if (!executarRodada(ia, profundidade, profundidade == 1 ? INT64_MAX : prazo)) break;
+
+        decisao.profundidade = profundidade;
+        decisao.pontuacao = PONTUACAO_PERDIDA;
+        decisao.lance.tipo = LANCE_NENHUM;
+        for (int i = 0; i < ia->totalLances; i++) {
+            if (ia->pontuacoes[i] > decisao.pontuacao) {
+                decisao.pontuacao = ia->pontuacoes[i];
+                decisao.lance = ia->lances[i];
+            }
+        }
+        if (relogioNs() > prazo) break;
+    }
+
+    for (int t = 0; t < ia->configuracao.threads; t++) {
+        decisao.nos += ia->trabalhadores[t].nos;
+        decisao.roubos += ia->trabalhadores[t].roubos;
+        decisao.consultasTabela += ia->trabalhadores[t].consultas;
+        decisao.acertosTabela += ia->trabalhadores[t].acertos;
+        decisao.substituicoesTabela += ia->trabalhadores[t].substituicoes;
+        if (ia->trabalhadores[t].rascunho.pico > decisao.rascunhoBytes) {
+            decisao.rascunhoBytes = ia->trabalhadores[t].rascunho.pico;
+        }
+    }
+    decisao.duracaoNs = relogioNs() - inicio;
+    return decisao;
+}
+
+// Função para executar no motor um lance escolhido, com as ações do menu:
+// troca (se for o caso), giros até a rotação, movimentos até a coluna e a jogada
+ResultadoAcao aplicarLance(EstadoJogo *estado, Lance lance) {
+    ResultadoAcao resultado;
+
+    switch (lance.tipo) {
+        case LANCE_RESERVAR:
+            return executarAcao(estado, ACAO_RESERVAR);
+        case LANCE_TROCAR_E_JOGAR:
+            resultado = executarAcao(estado, ACAO_TROCAR);
+            if (resultado != RESULTADO_OK) return resultado;
+            break;
+        case LANCE_JOGAR:
+        case LANCE_USAR_RESERVA:
+            break;
+        default:
+            return RESULTADO_FIM_DE_JOGO;
+    }
+
+    for (int i = 0; i < TOTAL_ROTACOES && estado->rotacaoMira != lance.rotacao; i++) {
+        resultado = executarAcao(estado, ACAO_GIRAR);
+        if (resultado != RESULTADO_OK) return resultado;
+    }
+    while (estado->colunaMira > lance.coluna) executarAcao(estado, ACAO_MOVER_ESQUERDA);
+    while (estado->colunaMira < lance.coluna) executarAcao(estado, ACAO_MOVER_DIREITA);
+
+    return executarAcao(estado, lance.tipo == LANCE_USAR_RESERVA ? ACAO_USAR_RESERVA : ACAO_JOGAR);
+}
@@ -0,0 +1,135 @@
+#ifndef IA_H
+#define IA_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "motor.h"
+#include "transposicao.h"
+
+// Jogador automático (bot)
+// A cada vez, enumera todos os lances possíveis com as peças conhecidas (a
+// fila inteira e a pilha de reserva) até a profundidade pedida, pontua os
+// tabuleiros resultantes com uma heurística e escolhe o melhor lance da raiz.
+//
+// A busca é dividida em tarefas (uma por lance da raiz) distribuídas entre as
+// filas de trabalho de um conjunto fixo de threads; quem esvazia a própria
+// fila rouba tarefas das outras (work stealing). O aprofundamento é
+// iterativo: a profundidade 1 sempre termina e cada profundidade seguinte só
+// é aceita se terminar dentro do orçamento de tempo da jogada. Os valores
+// dos estados já calculados ficam numa tabela de transposição compartilhada
+// (ver transposicao.h), que também vale entre uma jogada e a seguinte.
+// As listas de lances de cada nível da busca saem de uma arena por thread,
+// zerada a cada jogada, então decidir um lance não aloca memória.
+
+#define IA_MAX_THREADS 64
+#define IA_MAX_LANCES 512       // 3 origens x 4 rotações x 32 colunas + reservar
+
+// Origem da peça de um lance (opções 1 a 4 do menu)
+typedef enum {
+    LANCE_JOGAR = 0,            // joga a peça da frente da fila
+    LANCE_USAR_RESERVA,         // joga a peça do topo da pilha
+    LANCE_TROCAR_E_JOGAR,       // troca frente e topo e joga a nova frente
+    LANCE_RESERVAR,             // só guarda a peça da frente na pilha
+    LANCE_NENHUM                // nenhum lance possível (fim de jogo)
+} TipoLance;
+
+typedef struct {
+    unsigned char tipo;         // TipoLance
+    unsigned char rotacao;
+    signed char coluna;
+} Lance;
+
+// Pesos da heurística (pontuação = soma dos termos vezes os pesos)
+typedef struct {
+    double alturaAgregada;      // soma das alturas das colunas
+    double linhas;              // linhas removidas no caminho até a folha
+    double buracos;             // células vazias com algum bloco acima
+    double irregularidade;      // soma das diferenças de altura entre colunas vizinhas
+} PesosIa;
+
+typedef struct {
+    int threads;
+    int profundidade;           // número de lances à frente (limitado às peças conhecidas)
+    double orcamentoMs;         // tempo máximo por jogada
+    size_t megabytesTabela;     // tamanho da tabela de transposição (0 = sem tabela)
+    PesosIa pesos;
+} ConfiguracaoIa;
+
+// Estado enxuto usado na busca: só o tabuleiro e os tipos das peças conhecidas
+typedef struct {
+    Tabuleiro tabuleiro;
+    unsigned char fila[TAMANHO_FILA];       // fila[0] é a frente
+    unsigned char pilha[TAMANHO_PILHA];     // pilha[quantidadePilha - 1] é o topo
+    int quantidadeFila;
+    int quantidadePilha;
+    uint64_t chave;                         // chave de Zobrist do tabuleiro
+} NoBusca;
+
+// Resultado de uma decisão
+typedef struct {
+    Lance lance;
+    double pontuacao;
+    int profundidade;           // maior profundidade concluída dentro do orçamento
+    long nos;                   // tabuleiros avaliados
+    long roubos;                // tarefas executadas por uma thread que não era a dona
+    long consultasTabela;
+    long acertosTabela;
+    long substituicoesTabela;   // gravações que descartaram outro estado ainda desta jogada
+    size_t rascunhoBytes;       // maior uso da arena de rascunho entre as threads
+    int64_t duracaoNs;
+} DecisaoIa;
+
+// Uma thread do conjunto, com a sua fila de tarefas
+typedef struct {
+    pthread_t thread;
+    struct Ia *ia;
+    int indice;
+
+    pthread_mutex_t trava;
+    int tarefas[IA_MAX_LANCES];
+    int inicio;                 // o ladrão retira daqui
+    int fim;                    // a dona retira daqui
+    Arena rascunho;             // listas de lances da busca, zerada a cada jogada
+
+    long nos;
+    long roubos;
+    long consultas;
+    long acertos;
+    long substituicoes;
+    char preenchimento[64];     // evita que contadores de threads vizinhas dividam a linha de cache
+} TrabalhadorIa;
+
+typedef struct Ia {
+    ConfiguracaoIa configuracao;
+    TrabalhadorIa trabalhadores[IA_MAX_THREADS];
+    TabelaTransposicao tabela;
+    int usarTabela;
+
+    // Coordenação de cada rodada de busca
+    pthread_mutex_t trava;
+    pthread_cond_t inicioRodada;
+    pthread_cond_t fimRodada;
+    unsigned long rodada;
+    int ocupados;
+    int encerrar;
+
+    // Dados da rodada atual (só leitura para as threads)
+    NoBusca raiz;
+    Lance lances[IA_MAX_LANCES];
+    double pontuacoes[IA_MAX_LANCES];
+    int totalLances;
+    int profundidade;
+    int64_t prazoNs;
+    atomic_int esgotado;
+} Ia;
+
+ConfiguracaoIa configuracaoIaPadrao(void);
+int iniciarIa(Ia *ia, const ConfiguracaoIa *configuracao);
+void encerrarIa(Ia *ia);
+DecisaoIa decidirLance(Ia *ia, const EstadoJogo *estado);
+ResultadoAcao aplicarLance(EstadoJogo *estado, Lance lance);
+
+#endif
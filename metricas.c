@@ -0,0 +1,144 @@
+#include <math.h>
+#include <string.h>
+
+#include "metricas.h"
+
+#define LIMITE_HISTOGRAMA ((UINT64_C(1) << (FAIXAS_HISTOGRAMA + BITS_SUBFAIXA - 1)) - 1)
+
+void inicializarMetricas(MetricasJogo *metricas) {
+    memset(metricas, 0, sizeof(*metricas));
+}
+
+// Funções do histograma
+// Balde de um valor: os primeiros 2 * SUBFAIXAS_HISTOGRAMA são exatos; acima
+// disso, a faixa é a posição do bit mais alto e a subfaixa os bits seguintes
+static int baldeLatencia(uint64_t ns) {
+    if (ns < 2 * SUBFAIXAS_HISTOGRAMA) return (int) ns;
+
+    int deslocamento = 63 - __builtin_clzll(ns) - BITS_SUBFAIXA;
+    return deslocamento * SUBFAIXAS_HISTOGRAMA + (int) (ns >> deslocamento);
+}
+
+// Maior valor que cai no balde
+static uint64_t limiteBalde(int balde) {
+    if (balde < 2 * SUBFAIXAS_HISTOGRAMA) return (uint64_t) balde;
+
+    int deslocamento = balde / SUBFAIXAS_HISTOGRAMA - 1;
+    uint64_t mantissa = (uint64_t) (balde - deslocamento * SUBFAIXAS_HISTOGRAMA);
+    return ((mantissa + 1) << deslocamento) - 1;
+}
+
+void registrarLatencia(HistogramaLatencia *histograma, uint64_t ns) {
+    histograma->baldes[baldeLatencia(ns < LIMITE_HISTOGRAMA ? ns : LIMITE_HISTOGRAMA)]++;
+    histograma->total++;
+    histograma->somaNs += ns;
+    if (ns > histograma->maximoNs) histograma->maximoNs = ns;
+}
+
+// Função para estimar o percentil (0 a 100) das latências registradas
+// Retorna o limite superior do balde onde ele cai (nunca acima do máximo).
+uint64_t percentilLatencia(const HistogramaLatencia *histograma, double percentil) {
+    if (histograma->total == 0) return 0;
+
+    uint64_t posicao = (uint64_t) ceil(percentil / 100.0 * (double) histograma->total);
+    if (posicao < 1) posicao = 1;
+
+    uint64_t acumulado = 0;
+    for (int b = 0; b < BALDES_HISTOGRAMA; b++) {
+        acumulado += histograma->baldes[b];
+        if (acumulado >= posicao) {
+            uint64_t limite = limiteBalde(b);
+            return limite < histograma->maximoNs ? limite : histograma->maximoNs;
+        }
+    }
+    return histograma->maximoNs;
+}
+
+void registrarAcao(MetricasJogo *metricas, AcaoJogo acao, ResultadoAcao resultado, int64_t ns) {
+    if ((unsigned) acao >= TOTAL_ACOES) {
+        metricas->acoesDesconhecidas++;
+        return;
+    }
+    registrarLatencia(&metricas->latencia[acao], ns > 0 ? (uint64_t) ns : 0);
+    metricas->resultados[acao][resultado]++;
+}
+
+// Nomes curtos, usados na tabela e como chaves no JSON
+const char *nomeAcaoMetricas(AcaoJogo acao) {
+    static const char *const NOMES[TOTAL_ACOES] = {
+        "sair", "jogar", "reservar", "usar_reserva", "trocar", "desfazer", "inverter",
+        "visualizar_historico", "trocar_bloco", "mover_esquerda", "mover_direita", "girar"
+    };
+    return (unsigned) acao < TOTAL_ACOES ? NOMES[acao] : "desconhecida";
+}
+
+const char *nomeResultadoMetricas(ResultadoAcao resultado) {
+    static const char *const NOMES[TOTAL_RESULTADOS] = {
+        "ok", "fila_vazia", "pilha_cheia", "pilha_vazia", "estruturas_vazias",
+        "pecas_insuficientes", "historico_vazio", "fim_de_jogo", "limite_tabuleiro", "acao_invalida"
+    };
+    return (unsigned) resultado < TOTAL_RESULTADOS ? NOMES[resultado] : "desconhecido";
+}
+
+// Funções de saída
+void mostrarMetricas(const MetricasJogo *metricas, FILE *saida) {
+    fprintf(saida, "\n=== MÉTRICAS DAS AÇÕES (latência em ns) ===\n");
+    // Os cabeçalhos acentuados têm um byte a mais por acento na largura
+    fprintf(saida, "%-24s %10s %10s %9s %9s %9s %11s %10s\n",
+            "Ação", "Total", "Média", "p50", "p99", "p999", "Máxima", "Rejeitadas");
+
+    for (int a = 0; a < TOTAL_ACOES; a++) {
+        const HistogramaLatencia *histograma = &metricas->latencia[a];
+        if (histograma->total == 0) continue;
+
+        fprintf(saida, "%-22s %10llu %9.0f %9llu %9llu %9llu %10llu %10llu\n", nomeAcaoMetricas((AcaoJogo) a),
+                (unsigned long long) histograma->total, (double) histograma->somaNs / histograma->total,
+                (unsigned long long) percentilLatencia(histograma, 50),
+                (unsigned long long) percentilLatencia(histograma, 99),
+                (unsigned long long) percentilLatencia(histograma, 99.9),
+                (unsigned long long) histograma->maximoNs,
+                (unsigned long long) (histograma->total - metricas->resultados[a][RESULTADO_OK]));
+    }
+
+    // Rejeições por motivo, só as que aconteceram
+    int cabecalho = 0;
+    for (int a = 0; a < TOTAL_ACOES; a++) {
+        for (int r = RESULTADO_OK + 1; r < TOTAL_RESULTADOS; r++) {
+            if (metricas->resultados[a][r] == 0) continue;
+            if (!cabecalho) fprintf(saida, "Rejeições:\n");
+            cabecalho = 1;
+            fprintf(saida, "  %-22s %-20s %llu\n", nomeAcaoMetricas((AcaoJogo) a),
+                    nomeResultadoMetricas((ResultadoAcao) r), (unsigned long long) metricas->resultados[a][r]);
+        }
+    }
+    if (metricas->acoesDesconhecidas > 0) {
+        fprintf(saida, "Ações desconhecidas: %llu\n", (unsigned long long) metricas->acoesDesconhecidas);
+    }
+}
+
+void exportarMetricasJson(const MetricasJogo *metricas, FILE *saida) {
+    int primeira = 1;
+
+    fprintf(saida, "{\n  \"acoes\": [");
+    for (int a = 0; a < TOTAL_ACOES; a++) {
+        const HistogramaLatencia *histograma = &metricas->latencia[a];
+        if (histograma->total == 0) continue;
+
+        fprintf(saida, "%s\n    {\"acao\": \"%s\", \"total\": %llu, \"media_ns\": %.1f, ", primeira ? "" : ",",
+                nomeAcaoMetricas((AcaoJogo) a), (unsigned long long) histograma->total,
+                (double) histograma->somaNs / histograma->total);
+        fprintf(saida, "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"maximo_ns\": %llu,\n",
+                (unsigned long long) percentilLatencia(histograma, 50),
+                (unsigned long long) percentilLatencia(histograma, 99),
+                (unsigned long long) percentilLatencia(histograma, 99.9),
+                (unsigned long long) histograma->maximoNs);
+        fprintf(saida, "     \"resultados\": {");
+        for (int r = 0; r < TOTAL_RESULTADOS; r++) {
+            fprintf(saida, "%s\"%s\": %llu", r > 0 ? ", " : "", nomeResultadoMetricas((ResultadoAcao) r),
+                    (unsigned long long) metricas->resultados[a][r]);
+        }
+        fprintf(saida, "}}");
+        primeira = 0;
+    }
+    fprintf(saida, "\n  ],\n  \"acoes_desconhecidas\": %llu\n}\n", (unsigned long long) metricas->acoesDesconhecidas);
+}
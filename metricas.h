@@ -0,0 +1,51 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "motor.h"
+#include "relogio.h"
+
+// Métricas do motor: latência e resultados de cada ação
+// Quando EstadoJogo.metricas aponta para uma MetricasJogo, executarAcao mede
+// com o relógio monotônico o tempo de cada ação e conta o resultado (as
+// rejeições: fila vazia, pilha cheia...). Sem métricas o custo é um teste de
+// ponteiro por ação.
+//
+// A latência vai para um histograma no estilo HDR: faixas de potência de
+// dois, cada uma dividida em SUBFAIXAS_HISTOGRAMA partes iguais. Valores até
+// 2 * SUBFAIXAS_HISTOGRAMA ns são exatos e os demais têm erro relativo de no
+// máximo 1 / SUBFAIXAS_HISTOGRAMA, com memória fixa e registro em O(1).
+
+#define BITS_SUBFAIXA 4
+#define SUBFAIXAS_HISTOGRAMA (1 << BITS_SUBFAIXA)     // erro de no máximo 6,25%
+#define FAIXAS_HISTOGRAMA 37                            // até 2^40 ns (cerca de 18 minutos)
+#define BALDES_HISTOGRAMA (FAIXAS_HISTOGRAMA * SUBFAIXAS_HISTOGRAMA)
+
+#define TOTAL_RESULTADOS (RESULTADO_ACAO_INVALIDA + 1)
+
+typedef struct {
+    uint64_t baldes[BALDES_HISTOGRAMA];
+    uint64_t total;
+    uint64_t somaNs;
+    uint64_t maximoNs;
+} HistogramaLatencia;
+
+typedef struct MetricasJogo {
+    HistogramaLatencia latencia[TOTAL_ACOES];
+    uint64_t resultados[TOTAL_ACOES][TOTAL_RESULTADOS];
+    uint64_t acoesDesconhecidas;    // códigos fora de AcaoJogo
+} MetricasJogo;
+
+void inicializarMetricas(MetricasJogo *metricas);
+void registrarLatencia(HistogramaLatencia *histograma, uint64_t ns);
+uint64_t percentilLatencia(const HistogramaLatencia *histograma, double percentil);
+void registrarAcao(MetricasJogo *metricas, AcaoJogo acao, ResultadoAcao resultado, int64_t ns);
+
+const char *nomeAcaoMetricas(AcaoJogo acao);
+const char *nomeResultadoMetricas(ResultadoAcao resultado);
+void mostrarMetricas(const MetricasJogo *metricas, FILE *saida);
+void exportarMetricasJson(const MetricasJogo *metricas, FILE *saida);
+
+#endif
@@ -0,0 +1,525 @@
+#include <stdlib.h>
+
+#include "metricas.h"
+#include "motor.h"
+
+// Função para inicializar a fila circular
+void inicializarFila(FilaCircular *fila, GeradorPecas *gerador) {
+    Peca iniciais[TAMANHO_FILA];
+
+    inicializarFilaVazia(fila);
+    gerarLotePecas(gerador, iniciais, TAMANHO_FILA);
+    for (int i = 0; i < TAMANHO_FILA; i++) {
+        enfileirar(fila, iniciais[i]);
+    }
+}
+
+// Função para inicializar a pilha de reserva
+void inicializarPilha(PilhaReserva *pilha) {
+    pilha->topo = -1;
+    pilha->quantidade = 0;
+}
+
+// Funções de verificação de estado
+int pilhaVazia(PilhaReserva *pilha) {
+    return pilha->quantidade == 0;
+}
+
+int pilhaCheia(PilhaReserva *pilha) {
+    return pilha->quantidade == TAMANHO_PILHA;
+}
+
+int historicoVazio(HistoricoJogo *historico) {
+    return historico->quantidade == 0;
+}
+
+int historicoCheio(HistoricoJogo *historico) {
+    return historico->quantidade == historico->capacidade;
+}
+
+// Funções da pilha de reserva
+void empilhar(PilhaReserva *pilha, Peca peca) {
+    if (pilhaCheia(pilha)) return;
+
+    pilha->topo++;
+    pilha->pecas[pilha->topo] = peca;
+    pilha->quantidade++;
+}
+
+Peca desempilhar(PilhaReserva *pilha) {
+    if (pilhaVazia(pilha)) return PECA_VAZIA;
+
+    Peca pecaRemovida = pilha->pecas[pilha->topo];
+    pilha->topo--;
+    pilha->quantidade--;
+
+    return pecaRemovida;
+}
+
+Peca verTopoPilha(PilhaReserva *pilha) {
+    if (pilhaVazia(pilha)) return PECA_VAZIA;
+    return pilha->pecas[pilha->topo];
+}
+
+// Funções do histórico
+// Função para inicializar o histórico com a capacidade desejada
+// Retorna 1 em caso de sucesso e 0 se não houver memória (ou se a capacidade
+// for grande demais para ser alocada).
+int inicializarHistorico(HistoricoJogo *historico, size_t capacidade) {
+    if (capacidade == 0) capacidade = 1;
+
+    historico->registros = NULL;
+    if (capacidade <= HISTORICO_CAPACIDADE_MAXIMA) historico->registros = malloc(capacidade * sizeof(RegistroHistorico));
+    historico->capacidade = historico->registros != NULL ? capacidade : 0;
+    historico->inicio = 0;
+    historico->quantidade = 0;
+
+    return historico->registros != NULL;
+}
+
+void liberarHistorico(HistoricoJogo *historico) {
+    free(historico->registros);
+    historico->registros = NULL;
+    historico->capacidade = 0;
+    historico->quantidade = 0;
+}
+
+void limparHistorico(HistoricoJogo *historico) {
+    historico->inicio = 0;
+    historico->quantidade = 0;
+}
+
+// Converte uma posição lógica (0 = mais antigo) em índice do buffer
+static size_t indiceHistorico(HistoricoJogo *historico, size_t posicao) {
+    size_t indice = historico->inicio + posicao;
+    if (indice >= historico->capacidade) indice -= historico->capacidade;
+    return indice;
+}
+
+// Adiciona um registro em O(1); quando cheio, sobrescreve o mais antigo
+// Retorna o registro criado, para que a ação complete os dados da jogada
+RegistroHistorico *adicionarHistorico(HistoricoJogo *historico, AcaoJogo acao, Peca pecaA, Peca pecaB) {
+    if (historico->capacidade == 0) return NULL;
+
+    RegistroHistorico *registro;
+    if (historicoCheio(historico)) {
+        registro = &historico->registros[historico->inicio];
+        historico->inicio = indiceHistorico(historico, 1);
+    } else {
+        registro = &historico->registros[indiceHistorico(historico, historico->quantidade)];
+        historico->quantidade++;
+    }
+
+    registro->acao = (unsigned char) acao;
+    registro->coluna = 0;
+    registro->linha = 0;
+    registro->rotacao = 0;
+    registro->pecaA = pecaA;
+    registro->pecaB = pecaB;
+    registro->linhasLimpas = 0;
+    return registro;
+}
+
+// Remove e retorna o registro mais recente em O(1)
+RegistroHistorico removerHistorico(HistoricoJogo *historico) {
+    RegistroHistorico vazio = {ACAO_SAIR, 0, 0, 0, PECA_VAZIA, PECA_VAZIA, 0};
+    if (historicoVazio(historico)) return vazio;
+
+    historico->quantidade--;
+    return historico->registros[indiceHistorico(historico, historico->quantidade)];
+}
+
+// Retorna o registro de posição "recente" (0 = mais recente) sem removê-lo
+RegistroHistorico *registroHistorico(HistoricoJogo *historico, size_t recente) {
+    if (recente >= historico->quantidade) return NULL;
+    return &historico->registros[indiceHistorico(historico, historico->quantidade - 1 - recente)];
+}
+
+// Descrição textual de cada ação, usada na visualização do histórico
+const char *descricaoAcao(AcaoJogo acao) {
+    switch (acao) {
+        case ACAO_JOGAR:        return "Jogou peça da fila";
+        case ACAO_RESERVAR:     return "Reservou peça";
+        case ACAO_USAR_RESERVA: return "Usou peça da reserva";
+        case ACAO_TROCAR:       return "Trocou peça fila↔pilha";
+        case ACAO_TROCAR_BLOCO: return "Trocou 3 peças fila↔pilha";
+        case ACAO_DESFAZER:     return "Desfez ação";
+        case ACAO_INVERTER:     return "Inverteu fila com pilha";
+        case ACAO_MOVER_ESQUERDA: return "Moveu a mira para a esquerda";
+        case ACAO_MOVER_DIREITA:  return "Moveu a mira para a direita";
+        case ACAO_GIRAR:        return "Girou a peça";
+        default:                return "Ação desconhecida";
+    }
+}
+
+// Funções das operações avançadas
+// Troca, direto nos arrays, as "quantidade" primeiras peças da fila com as
+// "quantidade" peças do topo da pilha: a frente da fila troca com o topo, a
+// segunda da fila com a abaixo do topo e assim por diante. Não desloca nenhuma
+// outra peça e é a própria inversa (trocar de novo restaura o estado).
+void trocarPecasFilaPilha(FilaCircular *fila, PilhaReserva *pilha, int quantidade) {
+    if (quantidade > fila->quantidade || quantidade > pilha->quantidade) return;
+
+    Peca *topo = &pilha->pecas[pilha->topo];
+    for (int i = 0; i < quantidade; i++) {
+        Peca *pecaFila = posicaoFila(fila, i);
+        Peca pecaPilha = topo[-i];
+
+        topo[-i] = *pecaFila;
+        *pecaFila = pecaPilha;
+    }
+}
+
+// Troca a peça da frente da fila com a do topo da pilha
+void trocarPecaFilaPilha(FilaCircular *fila, PilhaReserva *pilha) {
+    trocarPecasFilaPilha(fila, pilha, 1);
+}
+
+// Posição da i-ésima peça da sequência formada pela fila (da frente para o
+// fim) seguida da pilha (do topo para a base)
+static Peca *posicaoSequencia(FilaCircular *fila, PilhaReserva *pilha, int i) {
+    if (i < fila->quantidade) return posicaoFila(fila, i);
+    return &pilha->pecas[pilha->topo - (i - fila->quantidade)];
+}
+
+// Inverte a sequência fila+pilha no próprio lugar: a frente da fila troca com
+// a base da pilha, a segunda da fila com a peça acima da base e assim por
+// diante. As quantidades de cada estrutura não mudam, então funciona para
+// quaisquer capacidades, não perde peças e é a própria inversa.
+void inverterFilaComPilha(FilaCircular *fila, PilhaReserva *pilha) {
+    int inicio = 0;
+    int fim = fila->quantidade + pilha->quantidade - 1;
+
+    while (inicio < fim) {
+        Peca *a = posicaoSequencia(fila, pilha, inicio++);
+        Peca *b = posicaoSequencia(fila, pilha, fim--);
+        Peca temp = *a;
+        *a = *b;
+        *b = temp;
+    }
+}
+
+// Configuração padrão: histórico do menu, tabuleiro 10x20 e semente 1
+ConfiguracaoJogo configuracaoPadrao(void) {
+    ConfiguracaoJogo configuracao = {HISTORICO_MAX, 1, LARGURA_PADRAO, ALTURA_PADRAO};
+    return configuracao;
+}
+
+// Função para começar uma nova partida reaproveitando a memória do histórico
+// já preparada em estado->historico (a capacidade da configuração é ignorada).
+// Não aloca nada, então pode ser usada com históricos de memória externa.
+void reiniciarJogo(EstadoJogo *estado, const ConfiguracaoJogo *configuracao) {
+    RegistroHistorico vazio = {ACAO_SAIR, 0, 0, 0, PECA_VAZIA, PECA_VAZIA, 0};
+
+    inicializarGerador(&estado->gerador, configuracao->semente, GERADOR_SACO);
+    inicializarFila(&estado->fila, &estado->gerador);
+    inicializarPilha(&estado->pilha);
+    inicializarTabuleiro(&estado->tabuleiro, configuracao->largura, configuracao->altura);
+    estado->colunaMira = (estado->tabuleiro.largura - 4) / 2;
+    estado->rotacaoMira = 0;
+    estado->linhasRemovidas = 0;
+    estado->pecaAfetada = PECA_VAZIA;
+    estado->pecaNova = PECA_VAZIA;
+    estado->acaoDesfeita = vazio;
+    estado->produtor = NULL;
+    estado->metricas = NULL;
+    estado->observador = NULL;
+    estado->contextoObservador = NULL;
+    limparHistorico(&estado->historico);
+}
+
+// Função para inicializar uma partida completa
+// Retorna 1 em caso de sucesso e 0 se não houver memória para o histórico.
+// A mesma semente sempre gera a mesma sequência de peças.
+int inicializarJogo(EstadoJogo *estado, const ConfiguracaoJogo *configuracao) {
+    if (!inicializarHistorico(&estado->historico, configuracao->capacidadeHistorico)) return 0;
+    reiniciarJogo(estado, configuracao);
+    return 1;
+}
+
+// Libera o histórico e, se houver, encerra a thread produtora de peças
+// (a memória do produtor continua sendo de quem o criou)
+void liberarJogo(EstadoJogo *estado) {
+    if (estado->produtor != NULL) {
+        encerrarProdutor(estado->produtor);
+        estado->produtor = NULL;
+    }
+    liberarHistorico(&estado->historico);
+}
+
+// Coluna onde a peça cai: a mira, ajustada para a peça caber na largura
+static int colunaDaPeca(EstadoJogo *estado, const FormaPeca *forma) {
+    int maxima = estado->tabuleiro.largura - forma->largura;
+    return estado->colunaMira < maxima ? estado->colunaMira : maxima;
+}
+
+// Giro da mira: a peça "tipo", posta no topo do tabuleiro na coluna da mira
+// (ajustada para caber), gira no sentido horário testando os chutes do SRS
+// Retorna a nova rotação, com a nova coluna da mira em *coluna, ou -1 se não couber.
+static int girarMira(const EstadoJogo *estado, TipoPeca tipo, int rotacao, int *coluna) {
+    const FormaPeca *forma = formaPeca(tipo, rotacao);
+    int maxima = estado->tabuleiro.largura - forma->largura;
+    int colunaPeca = *coluna < maxima ? *coluna : maxima;
+    int linha = estado->tabuleiro.altura - forma->altura;
+
+    int novaRotacao = girarPeca(&estado->tabuleiro, tipo, rotacao, GIRO_HORARIO, &colunaPeca, &linha);
+    if (novaRotacao >= 0) *coluna = colunaPeca;
+    return novaRotacao;
+}
+
+// Função para descobrir as rotações da mira alcançáveis com ACAO_GIRAR a partir
+// do estado atual, se a peça da frente da fila for do tipo "tipo" durante os giros
+// Retorna uma máscara com o bit r ligado para cada rotação r (a atual sempre está).
+unsigned rotacoesAlcancaveis(const EstadoJogo *estado, TipoPeca tipo) {
+    int coluna = estado->colunaMira;
+    int rotacao = estado->rotacaoMira;
+    unsigned mascara = 1u << rotacao;
+
+    for (int i = 1; i < TOTAL_ROTACOES; i++) {
+        rotacao = girarMira(estado, tipo, rotacao, &coluna);
+        if (rotacao < 0) break;
+        mascara |= 1u << rotacao;
+    }
+    return mascara;
+}
+
+// Deixa a peça cair no tabuleiro na coluna da mira
+// Retorna 0 se ela não cabe mais (fim de jogo), sem alterar nada.
+static int jogarNoTabuleiro(EstadoJogo *estado, Peca peca, Jogada *jogada) {
+    const FormaPeca *forma = formaPeca(peca.tipo, estado->rotacaoMira);
+    if (!soltarPeca(&estado->tabuleiro, forma, colunaDaPeca(estado, forma), jogada)) return 0;
+
+    estado->linhasRemovidas += __builtin_popcount(jogada->linhasLimpas);
+    return 1;
+}
+
+// Guarda no registro onde e com que rotação a peça foi fixada
+static void registrarJogada(EstadoJogo *estado, RegistroHistorico *registro, const Jogada *jogada) {
+    if (registro == NULL) return;
+
+    registro->coluna = (signed char) jogada->coluna;
+    registro->linha = (signed char) jogada->linha;
+    registro->rotacao = (unsigned char) estado->rotacaoMira;
+    registro->linhasLimpas = jogada->linhasLimpas;
+}
+
+// Retira do tabuleiro a peça de um registro, devolvendo as linhas removidas
+static void desfazerNoTabuleiro(EstadoJogo *estado, RegistroHistorico *registro) {
+    const FormaPeca *forma = formaPeca(registro->pecaA.tipo, registro->rotacao);
+    Jogada jogada = {registro->coluna, registro->linha, registro->linhasLimpas};
+
+    desfazerJogada(&estado->tabuleiro, forma, &jogada);
+    estado->linhasRemovidas -= __builtin_popcount(registro->linhasLimpas);
+}
+
+// Função para reverter a última ação registrada, restaurando fila, pilha e tabuleiro
+static void desfazerRegistro(EstadoJogo *estado, RegistroHistorico *registro) {
+    FilaCircular *fila = &estado->fila;
+    PilhaReserva *pilha = &estado->pilha;
+
+    switch (registro->acao) {
+        case ACAO_JOGAR:
+            // Retira a peça do tabuleiro e a de reposição, e devolve a jogada para a frente
+            desfazerNoTabuleiro(estado, registro);
+            removerTrasFila(fila);
+            enfileirarFrente(fila, registro->pecaA);
+            break;
+
+        case ACAO_RESERVAR:
+            removerTrasFila(fila);
+            desempilhar(pilha);
+            enfileirarFrente(fila, registro->pecaA);
+            break;
+
+        case ACAO_USAR_RESERVA:
+            desfazerNoTabuleiro(estado, registro);
+            empilhar(pilha, registro->pecaA);
+            break;
+
+        case ACAO_TROCAR:
+            // As trocas são a própria inversa
+            trocarPecaFilaPilha(fila, pilha);
+            break;
+
+        case ACAO_TROCAR_BLOCO:
+            trocarPecasFilaPilha(fila, pilha, TAMANHO_PILHA);
+            break;
+
+        case ACAO_INVERTER:
+            inverterFilaComPilha(fila, pilha);
+            break;
+
+        case ACAO_MOVER_ESQUERDA:
+        case ACAO_MOVER_DIREITA:
+            estado->colunaMira = registro->coluna;
+            break;
+
+        case ACAO_GIRAR:
+            estado->colunaMira = registro->coluna;
+            estado->rotacaoMira = registro->rotacao;
+            break;
+    }
+}
+
+// Gera a peça que repõe a fila, na thread produtora quando houver uma
+static Peca reporPeca(EstadoJogo *estado) {
+    if (estado->produtor != NULL) return proximaPecaProdutor(estado->produtor);
+    return proximaPeca(&estado->gerador);
+}
+
+// Aplica uma ação sobre o estado (ver executarAcao)
+static ResultadoAcao aplicarAcao(EstadoJogo *estado, AcaoJogo acao) {
+    FilaCircular *fila = &estado->fila;
+    PilhaReserva *pilha = &estado->pilha;
+    HistoricoJogo *historico = &estado->historico;
+    Jogada jogada;
+
+    switch (acao) {
+        case ACAO_JOGAR:
+            if (filaVazia(fila)) return RESULTADO_FILA_VAZIA;
+            if (!jogarNoTabuleiro(estado, verFrenteFila(fila), &jogada)) return RESULTADO_FIM_DE_JOGO;
+
+            estado->pecaAfetada = desenfileirar(fila);
+
+            // Repõe na fila
+            estado->pecaNova = reporPeca(estado);
+            enfileirar(fila, estado->pecaNova);
+            registrarJogada(estado, adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaNova), &jogada);
+            return RESULTADO_OK;
+
+        case ACAO_RESERVAR:
+            if (filaVazia(fila)) return RESULTADO_FILA_VAZIA;
+            if (pilhaCheia(pilha)) return RESULTADO_PILHA_CHEIA;
+
+            estado->pecaAfetada = desenfileirar(fila);
+            empilhar(pilha, estado->pecaAfetada);
+
+            // Repõe na fila
+            estado->pecaNova = reporPeca(estado);
+            enfileirar(fila, estado->pecaNova);
+            adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaNova);
+            return RESULTADO_OK;
+
+        case ACAO_USAR_RESERVA:
+            if (pilhaVazia(pilha)) return RESULTADO_PILHA_VAZIA;
+            if (!jogarNoTabuleiro(estado, verTopoPilha(pilha), &jogada)) return RESULTADO_FIM_DE_JOGO;
+
+            estado->pecaAfetada = desempilhar(pilha);
+            registrarJogada(estado, adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaAfetada), &jogada);
+            return RESULTADO_OK;
+
+        case ACAO_TROCAR:
+            if (filaVazia(fila) || pilhaVazia(pilha)) return RESULTADO_ESTRUTURAS_VAZIAS;
+
+            estado->pecaAfetada = verFrenteFila(fila);
+            estado->pecaNova = verTopoPilha(pilha);
+            trocarPecaFilaPilha(fila, pilha);
+            adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaNova);
+            return RESULTADO_OK;
+
+        case ACAO_TROCAR_BLOCO:
+            // Exige a pilha cheia e ao menos a mesma quantidade de peças na fila
+            if (!pilhaCheia(pilha) || fila->quantidade < TAMANHO_PILHA) return RESULTADO_PECAS_INSUFICIENTES;
+
+            estado->pecaAfetada = verFrenteFila(fila);
+            estado->pecaNova = verTopoPilha(pilha);
+            trocarPecasFilaPilha(fila, pilha, TAMANHO_PILHA);
+            adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaNova);
+            return RESULTADO_OK;
+
+        case ACAO_DESFAZER:
+            if (historicoVazio(historico)) return RESULTADO_HISTORICO_VAZIO;
+
+            estado->acaoDesfeita = removerHistorico(historico);
+            desfazerRegistro(estado, &estado->acaoDesfeita);
+            return RESULTADO_OK;
+
+        case ACAO_INVERTER:
+            if (filaVazia(fila) && pilhaVazia(pilha)) return RESULTADO_ESTRUTURAS_VAZIAS;
+
+            estado->pecaAfetada = verFrenteFila(fila);
+            estado->pecaNova = verTopoPilha(pilha);
+            inverterFilaComPilha(fila, pilha);
+            adicionarHistorico(historico, acao, estado->pecaAfetada, estado->pecaNova);
+            return RESULTADO_OK;
+
+        case ACAO_MOVER_ESQUERDA:
+        case ACAO_MOVER_DIREITA: {
+            int destino = estado->colunaMira + (acao == ACAO_MOVER_DIREITA ? 1 : -1);
+            if (destino < 0 || destino >= estado->tabuleiro.largura) return RESULTADO_LIMITE_TABULEIRO;
+
+            RegistroHistorico *registro = adicionarHistorico(historico, acao, PECA_VAZIA, PECA_VAZIA);
+            if (registro != NULL) registro->coluna = (signed char) estado->colunaMira;
+            estado->colunaMira = destino;
+            return RESULTADO_OK;
+        }
+
+        case ACAO_GIRAR: {
+            // Gira a peça da frente como se ela estivesse no topo do tabuleiro,
+            // na coluna da mira; os chutes podem deslocar a mira
+            if (filaVazia(fila)) return RESULTADO_FILA_VAZIA;
+
+            int coluna = estado->colunaMira;
+            int rotacao = girarMira(estado, (TipoPeca) verFrenteFila(fila).tipo, estado->rotacaoMira, &coluna);
+            if (rotacao < 0) return RESULTADO_LIMITE_TABULEIRO;
+
+            RegistroHistorico *registro = adicionarHistorico(historico, acao, PECA_VAZIA, PECA_VAZIA);
+            if (registro != NULL) {
+                registro->coluna = (signed char) estado->colunaMira;
+                registro->rotacao = (unsigned char) estado->rotacaoMira;
+            }
+            estado->colunaMira = coluna;
+            estado->rotacaoMira = rotacao;
+            return RESULTADO_OK;
+        }
+
+        case ACAO_SAIR:
+        case ACAO_VISUALIZAR_HISTORICO:
+            return RESULTADO_OK;
+
+        default:
+            return RESULTADO_ACAO_INVALIDA;
+    }
+}
+
+// Função para executar uma ação sobre o estado, sem nenhuma saída na tela
+// Ações aplicadas com sucesso são repassadas ao observador, se houver, e
+// todas são medidas quando há métricas.
+ResultadoAcao executarAcao(EstadoJogo *estado, AcaoJogo acao) {
+    ResultadoAcao resultado;
+
+    if (estado->metricas != NULL) {
+        int64_t inicio = relogioNs();
+        resultado = aplicarAcao(estado, acao);
+        registrarAcao(estado->metricas, acao, resultado, relogioNs() - inicio);
+    } else {
+        resultado = aplicarAcao(estado, acao);
+    }
+
+    if (estado->observador != NULL && resultado == RESULTADO_OK) {
+        estado->observador(estado->contextoObservador, acao);
+    }
+    return resultado;
+}
+
+// Função para executar uma sequência binária de ações (um byte por ação)
+// Retorna quantas ações foram aplicadas com sucesso.
+size_t executarAcoes(EstadoJogo *estado, const unsigned char *acoes, size_t quantidade) {
+    size_t aplicadas = 0;
+
+    for (size_t i = 0; i < quantidade; i++) {
+        aplicadas += executarAcao(estado, (AcaoJogo) acoes[i]) == RESULTADO_OK;
+    }
+
+    return aplicadas;
+}
+
+// Função para receber linhas de lixo de um adversário (ver versus.h)
+// As jogadas do histórico deixam de valer com o tabuleiro deslocado, então o
+// histórico é esvaziado: não se desfaz nada de antes do lixo.
+// Retorna 0 se o lixo empurrou blocos para fora do topo (fim de jogo).
+int receberLixo(EstadoJogo *estado, int quantidade, int buraco) {
+    if (!subirLixo(&estado->tabuleiro, quantidade, buraco)) return 0;
+    limparHistorico(&estado->historico);
+    return 1;
+}
@@ -0,0 +1,154 @@
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fila.h"
+#include "gerador.h"
+#include "peca.h"
+#include "produtor.h"
+#include "tabuleiro.h"
+
+// Motor do Tetris - Nível Mestre
+// Contém toda a lógica do jogo sem nenhuma entrada/saída, para que possa ser
+// usado tanto pelo jogo interativo quanto por simulações em lote.
+
+#define TAMANHO_FILA 5
+#define TAMANHO_PILHA 3
+#define HISTORICO_MAX 10      // capacidade padrão do histórico
+
+// Estrutura para a fila circular (ver fila.h)
+FILA_DEFINIR(FilaCircular, Peca, TAMANHO_FILA, , PECA_VAZIA)
+
+// Estrutura para a pilha de reserva
+typedef struct {
+    Peca pecas[TAMANHO_PILHA];
+    int topo;
+    int quantidade;
+} PilhaReserva;
+
+// Registro compacto de uma ação no histórico: guarda apenas o necessário
+// para desfazer a ação (o código da ação e as peças que ela moveu), em 16 bytes
+typedef struct {
+    unsigned char acao;     // AcaoJogo
+    signed char coluna;     // coluna onde a peça foi fixada (ou mira anterior, nos movimentos)
+    signed char linha;      // linha onde a peça foi fixada
+    unsigned char rotacao;  // rotação da peça fixada (ou rotação anterior, no giro)
+    Peca pecaA;             // peça que saiu da frente da fila ou do topo da pilha
+    Peca pecaB;             // peça que entrou no fim da fila ou saiu da pilha na troca
+    uint32_t linhasLimpas;  // linhas que a jogada removeu do tabuleiro
+} RegistroHistorico;
+
+// Estrutura para o histórico do jogo (buffer circular de capacidade fixa)
+typedef struct {
+    RegistroHistorico *registros;
+    size_t capacidade;
+    size_t inicio;          // posição do registro mais antigo
+    size_t quantidade;
+} HistoricoJogo;
+
+// Maior capacidade cujo tamanho em bytes ainda cabe num size_t
+#define HISTORICO_CAPACIDADE_MAXIMA (SIZE_MAX / sizeof(RegistroHistorico))
+
+// Ações do jogo (os valores são os mesmos das opções do menu)
+typedef enum {
+    ACAO_SAIR = 0,
+    ACAO_JOGAR = 1,
+    ACAO_RESERVAR = 2,
+    ACAO_USAR_RESERVA = 3,
+    ACAO_TROCAR = 4,
+    ACAO_DESFAZER = 5,
+    ACAO_INVERTER = 6,
+    ACAO_VISUALIZAR_HISTORICO = 7,  // apenas exibe; não altera o estado
+    ACAO_TROCAR_BLOCO = 8,
+    ACAO_MOVER_ESQUERDA = 9,
+    ACAO_MOVER_DIREITA = 10,
+    ACAO_GIRAR = 11,
+    TOTAL_ACOES
+} AcaoJogo;
+
+// Resultado da execução de uma ação
+typedef enum {
+    RESULTADO_OK = 0,
+    RESULTADO_FILA_VAZIA,
+    RESULTADO_PILHA_CHEIA,
+    RESULTADO_PILHA_VAZIA,
+    RESULTADO_ESTRUTURAS_VAZIAS,
+    RESULTADO_PECAS_INSUFICIENTES,
+    RESULTADO_HISTORICO_VAZIO,
+    RESULTADO_FIM_DE_JOGO,
+    RESULTADO_LIMITE_TABULEIRO,
+    RESULTADO_ACAO_INVALIDA
+} ResultadoAcao;
+
+// Parâmetros de uma partida (ver configuracaoPadrao)
+typedef struct {
+    size_t capacidadeHistorico;
+    uint64_t semente;
+    int largura;
+    int altura;
+} ConfiguracaoJogo;
+
+// Estado completo de uma partida
+typedef struct {
+    FilaCircular fila;
+    PilhaReserva pilha;
+    Tabuleiro tabuleiro;
+    int colunaMira;             // coluna onde a próxima peça jogada vai cair
+    int rotacaoMira;            // rotação com que ela vai cair (0 a 3)
+    long linhasRemovidas;       // total de linhas completas removidas
+    HistoricoJogo historico;
+    GeradorPecas gerador;
+    ProdutorPecas *produtor;    // quando não é NULL, as peças novas vêm dele (ver produtor.h)
+    Peca pecaAfetada;           // peça jogada, reservada, usada ou trocada pela última ação
+    Peca pecaNova;              // peça gerada para repor a fila na última ação
+    RegistroHistorico acaoDesfeita; // preenchida quando a última ação foi ACAO_DESFAZER
+    // Quando não é NULL, recebe a latência e o resultado de cada ação (ver metricas.h)
+    struct MetricasJogo *metricas;
+    // Chamado depois de cada ação aplicada com sucesso (por exemplo, para
+    // gravar a partida; ver gravacao.h). NULL quando ninguém observa.
+    void (*observador)(void *contexto, AcaoJogo acao);
+    void *contextoObservador;
+} EstadoJogo;
+
+// Funções de verificação de estado
+int pilhaVazia(PilhaReserva *pilha);
+int pilhaCheia(PilhaReserva *pilha);
+int historicoVazio(HistoricoJogo *historico);
+int historicoCheio(HistoricoJogo *historico);
+
+// Funções da fila circular
+void inicializarFila(FilaCircular *fila, GeradorPecas *gerador);
+
+// Funções da pilha de reserva
+void inicializarPilha(PilhaReserva *pilha);
+void empilhar(PilhaReserva *pilha, Peca peca);
+Peca desempilhar(PilhaReserva *pilha);
+Peca verTopoPilha(PilhaReserva *pilha);
+
+// Funções do histórico
+int inicializarHistorico(HistoricoJogo *historico, size_t capacidade);
+void liberarHistorico(HistoricoJogo *historico);
+void limparHistorico(HistoricoJogo *historico);
+RegistroHistorico *adicionarHistorico(HistoricoJogo *historico, AcaoJogo acao, Peca pecaA, Peca pecaB);
+RegistroHistorico removerHistorico(HistoricoJogo *historico);
+RegistroHistorico *registroHistorico(HistoricoJogo *historico, size_t recente);
+const char *descricaoAcao(AcaoJogo acao);
+
+// Funções das operações avançadas
+void trocarPecasFilaPilha(FilaCircular *fila, PilhaReserva *pilha, int quantidade);
+void trocarPecaFilaPilha(FilaCircular *fila, PilhaReserva *pilha);
+void inverterFilaComPilha(FilaCircular *fila, PilhaReserva *pilha);
+
+// Interface do motor
+ConfiguracaoJogo configuracaoPadrao(void);
+int inicializarJogo(EstadoJogo *estado, const ConfiguracaoJogo *configuracao);
+void reiniciarJogo(EstadoJogo *estado, const ConfiguracaoJogo *configuracao);
+void liberarJogo(EstadoJogo *estado);
+ResultadoAcao executarAcao(EstadoJogo *estado, AcaoJogo acao);
+size_t executarAcoes(EstadoJogo *estado, const unsigned char *acoes, size_t quantidade);
+int receberLixo(EstadoJogo *estado, int quantidade, int buraco);
+unsigned rotacoesAlcancaveis(const EstadoJogo *estado, TipoPeca tipo);
+
+#endif
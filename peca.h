@@ -0,0 +1,41 @@
+#ifndef PECA_H
+#define PECA_H
+
+// Tipos de peça (índice das tabelas de formas, ver formas.h)
+typedef enum {
+    PECA_I = 0,
+    PECA_O,
+    PECA_T,
+    PECA_L,
+    PECA_J,
+    PECA_S,
+    PECA_Z,
+    PECA_NENHUMA            // marca de peça vazia
+} TipoPeca;
+
+// Quantidade de tipos de peça
+#define TOTAL_TIPOS_PECA 7
+
+// Bits do id dentro da palavra de 32 bits da peça
+#define BITS_ID_PECA 29
+#define ID_PECA_NENHUMA ((1u << BITS_ID_PECA) - 1)
+
+// Estrutura para representar uma peça do Tetris, empacotada em 32 bits: o tipo
+// ocupa 3 bits e o id o resto. Os ids são crescentes e dão a volta depois de
+// 2^29 peças (o que só afeta a exibição).
+typedef struct {
+    unsigned tipo : 3;              // TipoPeca
+    unsigned id : BITS_ID_PECA;     // identificador único e crescente
+} Peca;
+
+_Static_assert(sizeof(Peca) == 4, "Peca deve caber em 32 bits");
+
+// Peça devolvida quando se tenta remover de uma estrutura vazia
+#define PECA_VAZIA ((Peca) {PECA_NENHUMA, ID_PECA_NENHUMA})
+
+// Letra usada para mostrar cada tipo na tela
+static inline char letraPeca(Peca peca) {
+    return "IOTLJSZ?"[peca.tipo];
+}
+
+#endif
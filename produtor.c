@@ -0,0 +1,90 @@
+#include <sched.h>
+
+#include "produtor.h"
+
+// Espera até a fila ter espaço (ou até o pedido de parada)
+static void esperarEspaco(ProdutorPecas *produtor) {
+    atomic_store(&produtor->dormindo, 1);
+
+    // A ocupação é conferida de novo com a trava: se o jogo retirou peças
+    // antes de ver "dormindo", a fila já não está cheia e não há o que esperar
+    pthread_mutex_lock(&produtor->trava);
+    while (ocupacaoFilaSpscProdutor(&produtor->fila) == FILA_ARMAZENAMENTO(CAPACIDADE_PRODUTOR) &&
+           !atomic_load(&produtor->parar)) {
+        pthread_cond_wait(&produtor->espaco, &produtor->trava);
+    }
+    pthread_mutex_unlock(&produtor->trava);
+
+    atomic_store(&produtor->dormindo, 0);
+}
+
+static void acordarProdutor(ProdutorPecas *produtor) {
+    pthread_mutex_lock(&produtor->trava);
+    pthread_cond_signal(&produtor->espaco);
+    pthread_mutex_unlock(&produtor->trava);
+}
+
+static void *executarProdutor(void *argumento) {
+    ProdutorPecas *produtor = argumento;
+    Peca lote[LOTE_PRODUTOR];
+
+    while (!atomic_load_explicit(&produtor->parar, memory_order_relaxed)) {
+        gerarLotePecas(&produtor->gerador, lote, LOTE_PRODUTOR);
+        for (int i = 0; i < LOTE_PRODUTOR; i++) {
+            while (!enfileirarSpscProdutor(&produtor->fila, lote[i])) {
+                esperarEspaco(produtor);
+                if (atomic_load(&produtor->parar)) return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Função para iniciar a thread produtora a partir do estado de "origem"
+// Retorna 1 em caso de sucesso e 0 se a thread não puder ser criada.
+int iniciarProdutor(ProdutorPecas *produtor, const GeradorPecas *origem) {
+    inicializarFilaSpscProdutor(&produtor->fila);
+    produtor->gerador = *origem;
+    atomic_init(&produtor->dormindo, 0);
+    atomic_init(&produtor->parar, 0);
+    produtor->esperasConsumidor = 0;
+    pthread_mutex_init(&produtor->trava, NULL);
+    pthread_cond_init(&produtor->espaco, NULL);
+
+    if (pthread_create(&produtor->thread, NULL, executarProdutor, produtor) != 0) {
+        pthread_mutex_destroy(&produtor->trava);
+        pthread_cond_destroy(&produtor->espaco);
+        return 0;
+    }
+    return 1;
+}
+
+void encerrarProdutor(ProdutorPecas *produtor) {
+    atomic_store(&produtor->parar, 1);
+    acordarProdutor(produtor);
+
+    pthread_join(produtor->thread, NULL);
+    pthread_mutex_destroy(&produtor->trava);
+    pthread_cond_destroy(&produtor->espaco);
+}
+
+// Retira a próxima peça (só a thread do jogo chama)
+Peca proximaPecaProdutor(ProdutorPecas *produtor) {
+    Peca peca;
+
+    // Fila vazia só acontece se o jogo consumir mais rápido do que o produtor
+    // gera; cede a CPU para ele em vez de girar. Aqui o produtor é acordado
+    // sem condição de ocupação: a leitura de "dormindo" abaixo não tem barreira
+    // completa e pode, raramente, perder o momento de acordá-lo.
+    while (!desenfileirarSpscProdutor(&produtor->fila, &peca)) {
+        produtor->esperasConsumidor++;
+        if (atomic_load(&produtor->dormindo)) acordarProdutor(produtor);
+        sched_yield();
+    }
+
+    if (atomic_load_explicit(&produtor->dormindo, memory_order_relaxed) &&
+        ocupacaoFilaSpscProdutor(&produtor->fila) <= FILA_ARMAZENAMENTO(CAPACIDADE_PRODUTOR) / 2) {
+        acordarProdutor(produtor);
+    }
+    return peca;
+}
@@ -0,0 +1,40 @@
+#ifndef PRODUTOR_H
+#define PRODUTOR_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "fila.h"
+#include "gerador.h"
+
+// Produtor de peças em segundo plano
+// Uma thread gera as peças (inclusive o embaralhamento dos sacos) e as deixa
+// prontas numa fila SPSC; o jogo só retira a próxima. O produtor continua do
+// ponto em que estava o gerador recebido, então a sequência de peças é
+// exatamente a mesma do modo síncrono.
+//
+// Quando a fila enche, o produtor dorme numa variável de condição; o jogo só
+// toca na trava quando o produtor está dormindo e a fila já esvaziou até a
+// metade, então no caso comum retirar uma peça é só uma leitura atômica.
+
+#define CAPACIDADE_PRODUTOR 1024
+#define LOTE_PRODUTOR 64
+
+FILA_SPSC_DEFINIR(FilaProdutor, Peca, CAPACIDADE_PRODUTOR, Produtor)
+
+typedef struct {
+    FilaProdutor fila;
+    GeradorPecas gerador;           // usado só pela thread produtora
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t espaco;
+    atomic_int dormindo;
+    atomic_int parar;
+    unsigned long esperasConsumidor;    // vezes em que o jogo encontrou a fila vazia
+} ProdutorPecas;
+
+int iniciarProdutor(ProdutorPecas *produtor, const GeradorPecas *origem);
+void encerrarProdutor(ProdutorPecas *produtor);
+Peca proximaPecaProdutor(ProdutorPecas *produtor);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Relógio monotônico em nanossegundos, usado por todos os módulos que medem
+// tempo. Fica no cabeçalho para que as medições das ações (metricas.h) não
+// paguem uma chamada de função a mais.
+static inline int64_t relogioNs(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (int64_t) agora.tv_sec * 1000000000 + agora.tv_nsec;
+}
+
+#endif
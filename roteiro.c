@@ -0,0 +1,154 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "metricas.h"
+#include "roteiro.h"
+
+// Apelidos aceitos além dos nomes de nomeAcaoMetricas
+static const struct {
+    const char *nome;
+    AcaoJogo acao;
+} APELIDOS[] = {
+    {"usar", ACAO_USAR_RESERVA},
+    {"historico", ACAO_VISUALIZAR_HISTORICO},
+    {"esquerda", ACAO_MOVER_ESQUERDA},
+    {"direita", ACAO_MOVER_DIREITA},
+};
+
+static int separadorRoteiro(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ';' || c == '#';
+}
+
+// Função para abrir um roteiro ("-" é a entrada padrão)
+// Retorna 1 em caso de sucesso e 0 se o arquivo não puder ser aberto.
+int abrirRoteiro(LeitorRoteiro *leitor, const char *caminho) {
+    memset(leitor, 0, sizeof(*leitor));
+
+    if (strcmp(caminho, "-") == 0) {
+        leitor->descritor = STDIN_FILENO;
+    } else {
+        leitor->descritor = open(caminho, O_RDONLY);
+        if (leitor->descritor < 0) return 0;
+        leitor->proprio = 1;
+    }
+
+    leitor->buffer = malloc(TAMANHO_BUFFER_ROTEIRO);
+    if (leitor->buffer == NULL) {
+        fecharRoteiro(leitor);
+        return 0;
+    }
+    leitor->linha = 1;
+    return 1;
+}
+
+void fecharRoteiro(LeitorRoteiro *leitor) {
+    if (leitor->proprio) close(leitor->descritor);
+    free(leitor->buffer);
+    leitor->buffer = NULL;
+    leitor->proprio = 0;
+}
+
+// Leva o que falta ler para o começo do buffer e completa com o arquivo
+// Retorna 0 no fim do arquivo (ou em caso de erro de leitura).
+static int encherRoteiro(LeitorRoteiro *leitor) {
+    size_t restante = leitor->fim - leitor->inicio;
+    memmove(leitor->buffer, leitor->buffer + leitor->inicio, restante);
+    leitor->inicio = 0;
+    leitor->fim = restante;
+
+    ssize_t lidos;
+    do {
+        lidos = read(leitor->descritor, leitor->buffer + leitor->fim, TAMANHO_BUFFER_ROTEIRO - leitor->fim);
+    } while (lidos < 0 && errno == EINTR);
+
+    if (lidos <= 0) {
+        leitor->fimArquivo = 1;
+        return 0;
+    }
+    leitor->fim += (size_t) lidos;
+    leitor->bytesLidos += lidos;
+    return 1;
+}
+
+// Função para traduzir um comando (número da opção ou nome da ação)
+// Retorna 1 se o comando é conhecido e 0 caso contrário.
+int acaoDoComando(const char *texto, size_t tamanho, AcaoJogo *acao) {
+    if (tamanho == 0 || tamanho > TAMANHO_MAXIMO_COMANDO) return 0;
+
+    // Números: o caso comum, sem comparar textos
+    if (texto[0] >= '0' && texto[0] <= '9') {
+        unsigned valor = 0;
+        for (size_t i = 0; i < tamanho; i++) {
+            if (texto[i] < '0' || texto[i] > '9' || valor >= TOTAL_ACOES) return 0;
+            valor = valor * 10 + (unsigned) (texto[i] - '0');
+        }
+        if (valor >= TOTAL_ACOES) return 0;
+        *acao = (AcaoJogo) valor;
+        return 1;
+    }
+
+    for (int a = 0; a < TOTAL_ACOES; a++) {
+        const char *nome = nomeAcaoMetricas((AcaoJogo) a);
+        if (nome[0] == texto[0] && strlen(nome) == tamanho && memcmp(nome, texto, tamanho) == 0) {
+            *acao = (AcaoJogo) a;
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < sizeof(APELIDOS) / sizeof(APELIDOS[0]); i++) {
+        const char *nome = APELIDOS[i].nome;
+        if (nome[0] == texto[0] && strlen(nome) == tamanho && memcmp(nome, texto, tamanho) == 0) {
+            *acao = APELIDOS[i].acao;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Função para ler o próximo comando do roteiro
+// Retorna 1 se leu uma ação, 0 no fim do roteiro e -1 num comando
+// desconhecido (copiado para leitor->comando; a linha fica em leitor->linha).
+int proximaAcaoRoteiro(LeitorRoteiro *leitor, AcaoJogo *acao) {
+    for (;;) {
+        // Separadores e comentários
+        while (leitor->inicio < leitor->fim) {
+            char c = leitor->buffer[leitor->inicio];
+            if (c == '\n') {
+                leitor->linha++;
+                leitor->emComentario = 0;
+            } else if (c == '#') {
+                leitor->emComentario = 1;
+            } else if (!leitor->emComentario && !separadorRoteiro(c)) {
+                break;
+            }
+            leitor->inicio++;
+        }
+        if (leitor->inicio == leitor->fim) {
+            if (leitor->fimArquivo || !encherRoteiro(leitor)) return 0;
+            continue;
+        }
+
+        // O comando vai até o próximo separador; se ele pode continuar no
+        // próximo bloco do arquivo, completa o buffer antes (a não ser que o
+        // comando já ocupe o buffer inteiro)
+        size_t fimComando = leitor->inicio;
+        while (fimComando < leitor->fim && !separadorRoteiro(leitor->buffer[fimComando])) fimComando++;
+        if (fimComando == leitor->fim && !leitor->fimArquivo &&
+            (leitor->inicio > 0 || leitor->fim < TAMANHO_BUFFER_ROTEIRO)) {
+            encherRoteiro(leitor);
+            continue;
+        }
+
+        const char *texto = leitor->buffer + leitor->inicio;
+        size_t tamanho = fimComando - leitor->inicio;
+        leitor->inicio = fimComando;
+        if (acaoDoComando(texto, tamanho, acao)) return 1;
+
+        size_t copiados = tamanho < TAMANHO_MAXIMO_COMANDO ? tamanho : TAMANHO_MAXIMO_COMANDO;
+        memcpy(leitor->comando, texto, copiados);
+        leitor->comando[copiados] = '\0';
+        return -1;
+    }
+}
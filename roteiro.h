@@ -0,0 +1,40 @@
+#ifndef ROTEIRO_H
+#define ROTEIRO_H
+
+#include <stddef.h>
+
+#include "motor.h"
+
+// Roteiros de ações em texto
+// Um roteiro é uma sequência de comandos separados por espaços, quebras de
+// linha, vírgulas ou ponto e vírgula; "#" começa um comentário até o fim da
+// linha. Cada comando é o número da opção do menu ("1", "9"...) ou o nome da
+// ação ("jogar", "mover_esquerda"... ver nomeAcaoMetricas), com alguns
+// apelidos curtos ("esquerda", "direita", "usar", "historico").
+//
+// O arquivo é lido com read() em blocos grandes e os comandos são separados
+// direto no buffer, sem cópia nem stdio, para que ler o roteiro custe pouco
+// perto de aplicar as ações.
+
+#define TAMANHO_BUFFER_ROTEIRO (1 << 20)
+#define TAMANHO_MAXIMO_COMANDO 63
+
+typedef struct {
+    int descritor;
+    int proprio;                // o descritor foi aberto aqui (não é a entrada padrão)
+    char *buffer;
+    size_t inicio;              // próximo byte ainda não lido do buffer
+    size_t fim;
+    int fimArquivo;
+    int emComentario;
+    long linha;                 // linha do comando atual (a partir de 1)
+    long long bytesLidos;
+    char comando[TAMANHO_MAXIMO_COMANDO + 1];   // último comando desconhecido
+} LeitorRoteiro;
+
+int abrirRoteiro(LeitorRoteiro *leitor, const char *caminho);
+int proximaAcaoRoteiro(LeitorRoteiro *leitor, AcaoJogo *acao);
+void fecharRoteiro(LeitorRoteiro *leitor);
+int acaoDoComando(const char *texto, size_t tamanho, AcaoJogo *acao);
+
+#endif
@@ -0,0 +1,407 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "relogio.h"
+#include "salvamento.h"
+
+static const char ASSINATURA[4] = {'T', 'T', 'R', 'S'};
+
+// FNV-1a de 64 bits: a imagem tem poucas centenas de bytes, então um hash
+// simples byte a byte custa menos que uma leitura do disco
+static uint64_t verificacaoImagem(const ImagemJogo *imagem, size_t tamanho) {
+    const unsigned char *dados = (const unsigned char *) imagem + sizeof(CabecalhoSalvamento);
+    uint64_t hash = UINT64_C(14695981039346656037);
+
+    for (size_t i = 0; i < tamanho - sizeof(CabecalhoSalvamento); i++) {
+        hash ^= dados[i];
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+size_t tamanhoImagem(size_t capacidadeHistorico) {
+    return offsetof(ImagemJogo, historico) + capacidadeHistorico * sizeof(RegistroHistorico);
+}
+
+// Função para copiar o estado da partida para a imagem, que deve ter
+// tamanhoImagem(estado->historico.capacidade) bytes
+void capturarImagem(ImagemJogo *imagem, const EstadoJogo *estado, uint64_t sequencia) {
+    const HistoricoJogo *historico = &estado->historico;
+    size_t tamanho = tamanhoImagem(historico->capacidade);
+
+    memcpy(imagem->cabecalho.assinatura, ASSINATURA, sizeof(ASSINATURA));
+    imagem->cabecalho.versao = SALVAMENTO_VERSAO;
+    imagem->cabecalho.tamanhoFixo = (uint32_t) offsetof(ImagemJogo, historico);
+    imagem->cabecalho.tamanho = (uint32_t) tamanho;
+    imagem->cabecalho.capacidadeHistorico = historico->capacidade;
+    imagem->cabecalho.sequencia = sequencia;
+
+    memcpy(&imagem->fila, &estado->fila, sizeof(FilaCircular));
+    memcpy(&imagem->pilha, &estado->pilha, sizeof(PilhaReserva));
+    memcpy(&imagem->tabuleiro, &estado->tabuleiro, sizeof(Tabuleiro));
+    memcpy(&imagem->gerador, &estado->gerador, sizeof(GeradorPecas));
+    imagem->colunaMira = estado->colunaMira;
+    imagem->rotacaoMira = estado->rotacaoMira;
+    imagem->linhasRemovidas = estado->linhasRemovidas;
+
+    // O histórico sai do buffer circular já em ordem, do mais antigo ao mais recente
+    imagem->quantidadeHistorico = historico->quantidade;
+    for (size_t i = 0; i < historico->quantidade; i++) {
+        imagem->historico[i] = historico->registros[(historico->inicio + i) % historico->capacidade];
+    }
+    memset(imagem->historico + historico->quantidade, 0,
+           (historico->capacidade - historico->quantidade) * sizeof(RegistroHistorico));
+
+    imagem->cabecalho.verificacao = verificacaoImagem(imagem, tamanho);
+}
+
+// Grava a imagem num arquivo temporário e o renomeia para o caminho final
+// Retorna 1 em caso de sucesso e 0 em caso de erro.
+static int escreverImagem(const ImagemJogo *imagem, const char *caminho, const char *temporario) {
+    int descritor = open(temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descritor < 0) return 0;
+
+    const unsigned char *dados = (const unsigned char *) imagem;
+    size_t restante = imagem->cabecalho.tamanho;
+    while (restante > 0) {
+        ssize_t escritos = write(descritor, dados, restante);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) {
+            close(descritor);
+            unlink(temporario);
+            return 0;
+        }
+        dados += escritos;
+        restante -= (size_t) escritos;
+    }
+
+    // Os dados precisam estar no disco antes da renomeação, senão uma queda
+    // de energia pode deixar o nome novo apontando para um arquivo vazio
+    if (fdatasync(descritor) != 0 || close(descritor) != 0) {
+        unlink(temporario);
+        return 0;
+    }
+    return rename(temporario, caminho) == 0;
+}
+
+static char *caminhoTemporarioDe(const char *caminho) {
+    size_t tamanho = strlen(caminho) + sizeof(".tmp");
+    char *temporario = malloc(tamanho);
+    if (temporario != NULL) snprintf(temporario, tamanho, "%s.tmp", caminho);
+    return temporario;
+}
+
+// Função para salvar a partida de uma vez, na thread que chama
+// Retorna 1 em caso de sucesso e 0 em caso de erro.
+int salvarJogo(const EstadoJogo *estado, const char *caminho) {
+    ImagemJogo *imagem = malloc(tamanhoImagem(estado->historico.capacidade));
+    char *temporario = caminhoTemporarioDe(caminho);
+    int sucesso = 0;
+
+    if (imagem != NULL && temporario != NULL) {
+        capturarImagem(imagem, estado, 0);
+        sucesso = escreverImagem(imagem, caminho, temporario);
+    }
+    free(temporario);
+    free(imagem);
+    return sucesso;
+}
+
+static int pecaValida(Peca peca) {
+    return peca.tipo < TOTAL_TIPOS_PECA;
+}
+
+static int filaValida(const FilaCircular *original) {
+    FilaCircular fila = *original;
+
+    if (fila.quantidade < 0 || fila.quantidade > TAMANHO_FILA || fila.frente < 0 ||
+        (unsigned) fila.frente >= FILA_ARMAZENAMENTO(TAMANHO_FILA)) {
+        return 0;
+    }
+    for (int i = 0; i < fila.quantidade; i++) {
+        if (!pecaValida(*posicaoFila(&fila, i))) return 0;
+    }
+    return 1;
+}
+
+static int pilhaValida(const PilhaReserva *pilha) {
+    if (pilha->quantidade < 0 || pilha->quantidade > TAMANHO_PILHA || pilha->topo != pilha->quantidade - 1) return 0;
+    for (int i = 0; i < pilha->quantidade; i++) {
+        if (!pecaValida(pilha->pecas[i])) return 0;
+    }
+    return 1;
+}
+
+static int tabuleiroValido(const Tabuleiro *tabuleiro) {
+    if (tabuleiro->largura < 4 || tabuleiro->largura > LARGURA_MAXIMA ||
+        tabuleiro->altura < 4 || tabuleiro->altura > ALTURA_MAXIMA) {
+        return 0;
+    }
+    uint32_t linhaCheia = tabuleiro->largura == 32 ? 0xFFFFFFFFu : (1u << tabuleiro->largura) - 1;
+    if (tabuleiro->linhaCheia != linhaCheia) return 0;
+
+    // Nenhum bloco fora da largura nem acima da altura
+    for (int r = 0; r < ALTURA_MAXIMA; r++) {
+        uint32_t permitidas = r < tabuleiro->altura ? linhaCheia : 0;
+        if (tabuleiro->linhas[r] & ~permitidas) return 0;
+    }
+    return 1;
+}
+
+static int geradorValido(const GeradorPecas *gerador) {
+    if ((gerador->modo != GERADOR_SACO && gerador->modo != GERADOR_UNIFORME) ||
+        gerador->posicaoSaco < 0 || gerador->posicaoSaco > TOTAL_TIPOS_PECA) {
+        return 0;
+    }
+    for (int i = gerador->posicaoSaco; i < TOTAL_TIPOS_PECA; i++) {
+        if (gerador->saco[i] >= TOTAL_TIPOS_PECA) return 0;
+    }
+    return 1;
+}
+
+// Um registro só é aceito se desfazê-lo não sai do tabuleiro: a peça fixada
+// cabe na posição registrada e as linhas removidas estão entre as que ela ocupa
+static int registroValido(const RegistroHistorico *registro, const Tabuleiro *tabuleiro) {
+    switch (registro->acao) {
+        case ACAO_JOGAR:
+        case ACAO_USAR_RESERVA: {
+            if (!pecaValida(registro->pecaA) || registro->rotacao >= TOTAL_ROTACOES) return 0;
+
+            const FormaPeca *forma = formaPeca((TipoPeca) registro->pecaA.tipo, registro->rotacao);
+            if (registro->coluna < 0 || registro->coluna + forma->largura > tabuleiro->largura ||
+                registro->linha < 0 || registro->linha + forma->altura > tabuleiro->altura) {
+                return 0;
+            }
+            uint32_t ocupadas = ((1u << forma->altura) - 1) << registro->linha;
+            return (registro->linhasLimpas & ~ocupadas) == 0;
+        }
+
+        case ACAO_RESERVAR:
+            return pecaValida(registro->pecaA);
+
+        case ACAO_TROCAR:
+        case ACAO_TROCAR_BLOCO:
+        case ACAO_INVERTER:
+            return 1;
+
+        case ACAO_MOVER_ESQUERDA:
+        case ACAO_MOVER_DIREITA:
+            return registro->coluna >= 0 && registro->coluna < tabuleiro->largura;
+
+        case ACAO_GIRAR:
+            return registro->coluna >= 0 && registro->coluna < tabuleiro->largura &&
+                   registro->rotacao < TOTAL_ROTACOES;
+
+        default:
+            return 0;
+    }
+}
+
+// Confere se a imagem mapeada é um salvamento íntegro desta versão
+static int imagemValida(const ImagemJogo *imagem, size_t tamanhoArquivo) {
+    const CabecalhoSalvamento *cabecalho = &imagem->cabecalho;
+
+    if (memcmp(cabecalho->assinatura, ASSINATURA, sizeof(ASSINATURA)) != 0 ||
+        cabecalho->versao != SALVAMENTO_VERSAO || cabecalho->tamanhoFixo != offsetof(ImagemJogo, historico) ||
+        cabecalho->tamanho != tamanhoArquivo || cabecalho->capacidadeHistorico == 0 ||
+        cabecalho->capacidadeHistorico > (tamanhoArquivo - offsetof(ImagemJogo, historico)) / sizeof(RegistroHistorico) ||
+        tamanhoImagem(cabecalho->capacidadeHistorico) != tamanhoArquivo) {
+        return 0;
+    }
+    if (verificacaoImagem(imagem, tamanhoArquivo) != cabecalho->verificacao) return 0;
+
+    // A soma de verificação só garante que o arquivo não foi corrompido; os
+    // índices e enums ainda precisam estar nos limites que o motor assume,
+    // senão um arquivo forjado (ou de outra versão do programa) faria o
+    // motor ler e escrever fora das estruturas
+    if (!filaValida(&imagem->fila) || !pilhaValida(&imagem->pilha) || !tabuleiroValido(&imagem->tabuleiro) ||
+        !geradorValido(&imagem->gerador) || imagem->linhasRemovidas < 0 ||
+        imagem->colunaMira < 0 || imagem->colunaMira >= imagem->tabuleiro.largura ||
+        imagem->rotacaoMira < 0 || imagem->rotacaoMira >= TOTAL_ROTACOES ||
+        imagem->quantidadeHistorico > cabecalho->capacidadeHistorico) {
+        return 0;
+    }
+    for (uint64_t i = 0; i < imagem->quantidadeHistorico; i++) {
+        if (!registroValido(&imagem->historico[i], &imagem->tabuleiro)) return 0;
+    }
+    return 1;
+}
+
+// Função para retomar a partida salva em "caminho"
+// O histórico do estado mantém a sua capacidade; se o salvamento tiver mais
+// registros do que ela, ficam os mais recentes.
+// Retorna 1 se carregou, 0 se o arquivo não existe e -1 se ele é inválido
+// (nesses casos o estado não é alterado).
+int carregarJogo(EstadoJogo *estado, const char *caminho) {
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return errno == ENOENT ? 0 : -1;
+
+    struct stat informacoes;
+    if (fstat(descritor, &informacoes) != 0 || (size_t) informacoes.st_size < tamanhoImagem(1)) {
+        close(descritor);
+        return -1;
+    }
+
+    size_t tamanho = (size_t) informacoes.st_size;
+    void *dados = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (dados == MAP_FAILED) return -1;
+
+    const ImagemJogo *imagem = dados;
+    if (!imagemValida(imagem, tamanho)) {
+        munmap(dados, tamanho);
+        return -1;
+    }
+
+    memcpy(&estado->fila, &imagem->fila, sizeof(FilaCircular));
+    memcpy(&estado->pilha, &imagem->pilha, sizeof(PilhaReserva));
+    memcpy(&estado->tabuleiro, &imagem->tabuleiro, sizeof(Tabuleiro));
+    memcpy(&estado->gerador, &imagem->gerador, sizeof(GeradorPecas));
+    estado->colunaMira = imagem->colunaMira;
+    estado->rotacaoMira = imagem->rotacaoMira;
+    estado->linhasRemovidas = (long) imagem->linhasRemovidas;
+    estado->pecaAfetada = PECA_VAZIA;
+    estado->pecaNova = PECA_VAZIA;
+
+    HistoricoJogo *historico = &estado->historico;
+    size_t quantidade = imagem->quantidadeHistorico;
+    size_t primeiro = quantidade > historico->capacidade ? quantidade - historico->capacidade : 0;
+    limparHistorico(historico);
+    memcpy(historico->registros, imagem->historico + primeiro, (quantidade - primeiro) * sizeof(RegistroHistorico));
+    historico->quantidade = quantidade - primeiro;
+
+    munmap(dados, tamanho);
+    return 1;
+}
+
+// Funções do salvamento automático
+// Espera um pedido até o instante "prazoNs" do relógio monotônico
+static void esperarPedidoAte(SalvamentoAutomatico *salvamento, int64_t prazoNs) {
+    struct timespec prazo = {(time_t) (prazoNs / 1000000000), (long) (prazoNs % 1000000000)};
+    pthread_cond_timedwait(&salvamento->pedido, &salvamento->trava, &prazo);
+}
+
+static void *executarSalvamento(void *argumento) {
+    SalvamentoAutomatico *salvamento = argumento;
+    int64_t proximaGravacaoNs = relogioNs();
+
+    pthread_mutex_lock(&salvamento->trava);
+    for (;;) {
+        while (!salvamento->pendente && !salvamento->parar) {
+            pthread_cond_wait(&salvamento->pedido, &salvamento->trava);
+        }
+        if (!salvamento->pendente) break;
+
+        // No máximo uma gravação por intervalo; enquanto espera, o jogo pode
+        // trocar a imagem de entrega por outra mais nova. Ao encerrar, grava já.
+        while (!salvamento->parar && relogioNs() < proximaGravacaoNs) {
+            esperarPedidoAte(salvamento, proximaGravacaoNs);
+        }
+
+        ImagemJogo *imagem = salvamento->imagemEntrega;
+        salvamento->imagemEntrega = salvamento->imagemDisco;
+        salvamento->imagemDisco = imagem;
+        salvamento->pendente = 0;
+        pthread_mutex_unlock(&salvamento->trava);
+
+        int sucesso = escreverImagem(imagem, salvamento->caminho, salvamento->caminhoTemporario);
+        proximaGravacaoNs = relogioNs() + salvamento->intervaloNs;
+
+        pthread_mutex_lock(&salvamento->trava);
+        if (sucesso) {
+            salvamento->gravados++;
+        } else {
+            salvamento->erros++;
+        }
+    }
+    pthread_mutex_unlock(&salvamento->trava);
+    return NULL;
+}
+
+static void liberarBuffers(SalvamentoAutomatico *salvamento) {
+    free(salvamento->imagemJogo);
+    free(salvamento->imagemEntrega);
+    free(salvamento->imagemDisco);
+    free(salvamento->caminho);
+    free(salvamento->caminhoTemporario);
+}
+
+// Função para iniciar a thread de salvamento automático em "caminho"
+// Todos os buffers são reservados aqui; salvar depois não aloca nada.
+// Retorna 1 em caso de sucesso e 0 se faltar memória ou a thread não puder ser criada.
+int iniciarSalvamento(SalvamentoAutomatico *salvamento, const char *caminho, size_t capacidadeHistorico,
+                      int intervaloMs) {
+    memset(salvamento, 0, sizeof(*salvamento));
+    salvamento->tamanho = tamanhoImagem(capacidadeHistorico);
+    salvamento->capacidadeHistorico = capacidadeHistorico;
+    salvamento->intervaloNs = (int64_t) (intervaloMs > 0 ? intervaloMs : 0) * 1000000;
+    salvamento->imagemJogo = calloc(1, salvamento->tamanho);
+    salvamento->imagemEntrega = calloc(1, salvamento->tamanho);
+    salvamento->imagemDisco = calloc(1, salvamento->tamanho);
+    salvamento->caminho = strdup(caminho);
+    salvamento->caminhoTemporario = caminhoTemporarioDe(caminho);
+    if (salvamento->imagemJogo == NULL || salvamento->imagemEntrega == NULL || salvamento->imagemDisco == NULL ||
+        salvamento->caminho == NULL || salvamento->caminhoTemporario == NULL) {
+        liberarBuffers(salvamento);
+        return 0;
+    }
+
+    // O prazo entre gravações é contado no relógio monotônico
+    pthread_condattr_t atributos;
+    pthread_condattr_init(&atributos);
+    pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+    pthread_cond_init(&salvamento->pedido, &atributos);
+    pthread_condattr_destroy(&atributos);
+    pthread_mutex_init(&salvamento->trava, NULL);
+
+    if (pthread_create(&salvamento->thread, NULL, executarSalvamento, salvamento) != 0) {
+        pthread_mutex_destroy(&salvamento->trava);
+        pthread_cond_destroy(&salvamento->pedido);
+        liberarBuffers(salvamento);
+        return 0;
+    }
+    return 1;
+}
+
+// Função para entregar o estado atual à thread de salvamento (só a thread do
+// jogo chama). Copia o estado para o buffer do jogo e troca os ponteiros; a
+// espera pela trava é no máximo a de outra troca de ponteiros.
+void salvarAutomatico(SalvamentoAutomatico *salvamento, const EstadoJogo *estado) {
+    if (estado->historico.capacidade != salvamento->capacidadeHistorico) return;
+
+    capturarImagem(salvamento->imagemJogo, estado, ++salvamento->sequencia);
+
+    pthread_mutex_lock(&salvamento->trava);
+    ImagemJogo *imagem = salvamento->imagemEntrega;
+    salvamento->imagemEntrega = salvamento->imagemJogo;
+    salvamento->imagemJogo = imagem;
+    salvamento->pendente = 1;
+    salvamento->entregues++;
+    pthread_cond_signal(&salvamento->pedido);
+    pthread_mutex_unlock(&salvamento->trava);
+}
+
+// Função para encerrar a thread de salvamento, gravando antes o estado final
+// (quando "estado" não é NULL) sem esperar o intervalo
+// Retorna 1 se nenhuma gravação falhou e 0 caso contrário.
+int encerrarSalvamento(SalvamentoAutomatico *salvamento, const EstadoJogo *estado) {
+    if (estado != NULL) salvarAutomatico(salvamento, estado);
+
+    pthread_mutex_lock(&salvamento->trava);
+    salvamento->parar = 1;
+    pthread_cond_signal(&salvamento->pedido);
+    pthread_mutex_unlock(&salvamento->trava);
+
+    pthread_join(salvamento->thread, NULL);
+    pthread_mutex_destroy(&salvamento->trava);
+    pthread_cond_destroy(&salvamento->pedido);
+    liberarBuffers(salvamento);
+    return salvamento->erros == 0;
+}
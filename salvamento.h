@@ -0,0 +1,85 @@
+#ifndef SALVAMENTO_H
+#define SALVAMENTO_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "motor.h"
+
+// Salvamento do estado completo da partida
+// Diferente da gravação (gravacao.h), que guarda as ações para refazer a
+// partida do início, aqui vai uma imagem do estado: fila, pilha, tabuleiro,
+// mira, histórico e o gerador de peças na posição em que estava. O arquivo
+// tem layout fixo, igual ao da struct ImagemJogo, então carregar é mapear o
+// arquivo, conferir o cabeçalho e copiar alguns blocos de memória.
+//
+// O layout é o nativo do programa (ordem dos bytes, alinhamento): o arquivo
+// serve para retomar a partida na mesma máquina, não para ser trocado entre
+// plataformas. O cabeçalho guarda o tamanho da parte fixa, para recusar
+// arquivos de uma versão com outro layout.
+//
+// O salvamento automático não trava o jogo: a thread do jogo copia o estado
+// para um buffer seu e o troca pelo buffer de entrega; uma thread à parte
+// troca o de entrega pelo seu e grava no disco. A trava só protege a troca
+// dos ponteiros, nunca a escrita, e se o jogo entregar várias imagens antes
+// de uma gravação só a mais recente é gravada. A gravação vai para um arquivo
+// temporário que depois é renomeado, então uma queda no meio dela deixa o
+// salvamento anterior intacto.
+
+#define SALVAMENTO_VERSAO 1
+
+typedef struct {
+    char assinatura[4];             // "TTRS"
+    uint32_t versao;
+    uint32_t tamanhoFixo;           // offsetof(ImagemJogo, historico)
+    uint32_t tamanho;               // bytes do arquivo inteiro
+    uint64_t capacidadeHistorico;
+    uint64_t sequencia;             // número da captura (cresce a cada salvamento)
+    uint64_t verificacao;           // FNV-1a de tudo o que vem depois do cabeçalho
+} CabecalhoSalvamento;
+
+typedef struct {
+    CabecalhoSalvamento cabecalho;
+    FilaCircular fila;
+    PilhaReserva pilha;
+    Tabuleiro tabuleiro;
+    GeradorPecas gerador;
+    int32_t colunaMira;
+    int32_t rotacaoMira;
+    int64_t linhasRemovidas;
+    uint64_t quantidadeHistorico;
+    RegistroHistorico historico[];  // do mais antigo ao mais recente
+} ImagemJogo;
+
+typedef struct {
+    ImagemJogo *imagemJogo;         // só a thread do jogo usa
+    ImagemJogo *imagemEntrega;      // trocada sob a trava
+    ImagemJogo *imagemDisco;        // só a thread de gravação usa
+    size_t tamanho;
+    size_t capacidadeHistorico;
+    char *caminho;
+    char *caminhoTemporario;
+    int64_t intervaloNs;            // mínimo entre duas gravações
+    uint64_t sequencia;
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t pedido;
+    int pendente;                   // imagemEntrega ainda não foi gravada
+    int parar;
+    unsigned long entregues;        // capturas entregues pelo jogo
+    unsigned long gravados;
+    unsigned long erros;
+} SalvamentoAutomatico;
+
+size_t tamanhoImagem(size_t capacidadeHistorico);
+void capturarImagem(ImagemJogo *imagem, const EstadoJogo *estado, uint64_t sequencia);
+int salvarJogo(const EstadoJogo *estado, const char *caminho);
+int carregarJogo(EstadoJogo *estado, const char *caminho);
+
+int iniciarSalvamento(SalvamentoAutomatico *salvamento, const char *caminho, size_t capacidadeHistorico,
+                      int intervaloMs);
+void salvarAutomatico(SalvamentoAutomatico *salvamento, const EstadoJogo *estado);
+int encerrarSalvamento(SalvamentoAutomatico *salvamento, const EstadoJogo *estado);
+
+#endif
@@ -0,0 +1,156 @@
+#include <string.h>
+
+#include "tabuleiro.h"
+
+// Função para inicializar um tabuleiro vazio (as dimensões são limitadas aos máximos)
+void inicializarTabuleiro(Tabuleiro *tabuleiro, int largura, int altura) {
+    if (largura < 4) largura = 4;
+    if (largura > LARGURA_MAXIMA) largura = LARGURA_MAXIMA;
+    if (altura < 4) altura = 4;
+    if (altura > ALTURA_MAXIMA) altura = ALTURA_MAXIMA;
+
+    memset(tabuleiro->linhas, 0, sizeof(tabuleiro->linhas));
+    tabuleiro->largura = largura;
+    tabuleiro->altura = altura;
+    tabuleiro->linhaCheia = largura == 32 ? 0xFFFFFFFFu : (1u << largura) - 1;
+}
+
+// Verifica se a forma sai do tabuleiro ou sobrepõe algum bloco
+int colide(const Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha) {
+    if (coluna < 0 || linha < 0 || coluna + forma->largura > tabuleiro->largura ||
+        linha + forma->altura > tabuleiro->altura) {
+        return 1;
+    }
+
+    for (int r = 0; r < forma->altura; r++) {
+        if (tabuleiro->linhas[linha + r] & ((uint32_t) forma->linhas[r] << coluna)) return 1;
+    }
+    return 0;
+}
+
+// Linha em que a peça para ao cair na coluna dada, partindo do topo
+// Retorna -1 se ela não cabe nem no topo (fim de jogo).
+int linhaDeQueda(const Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna) {
+    int linha = tabuleiro->altura - forma->altura;
+    if (colide(tabuleiro, forma, coluna, linha)) return -1;
+
+    while (linha > 0 && !colide(tabuleiro, forma, coluna, linha - 1)) {
+        linha--;
+    }
+    return linha;
+}
+
+void fixarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha) {
+    for (int r = 0; r < forma->altura; r++) {
+        tabuleiro->linhas[linha + r] |= (uint32_t) forma->linhas[r] << coluna;
+    }
+}
+
+// Retira uma peça fixada (os bits dela estão todos ligados, então basta o XOR)
+void retirarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha) {
+    for (int r = 0; r < forma->altura; r++) {
+        tabuleiro->linhas[linha + r] ^= (uint32_t) forma->linhas[r] << coluna;
+    }
+}
+
+// Remove as linhas completas entre linhaInicial e linhaInicial + quantidade - 1
+// (as únicas que a última peça pode ter completado) e desce as de cima.
+// Retorna a máscara das linhas removidas.
+uint32_t limparLinhas(Tabuleiro *tabuleiro, int linhaInicial, int quantidade) {
+    uint32_t removidas = 0;
+    for (int r = linhaInicial; r < linhaInicial + quantidade && r < tabuleiro->altura; r++) {
+        if (tabuleiro->linhas[r] == tabuleiro->linhaCheia) removidas |= 1u << r;
+    }
+    if (removidas == 0) return 0;
+
+    int destino = linhaInicial;
+    for (int r = linhaInicial; r < tabuleiro->altura; r++) {
+        if (!(removidas & (1u << r))) {
+            tabuleiro->linhas[destino++] = tabuleiro->linhas[r];
+        }
+    }
+    while (destino < tabuleiro->altura) {
+        tabuleiro->linhas[destino++] = 0;
+    }
+
+    return removidas;
+}
+
+// Desfaz limparLinhas: reinsere linhas completas nas posições originais
+void restaurarLinhas(Tabuleiro *tabuleiro, uint32_t linhasLimpas) {
+    if (linhasLimpas == 0) return;
+
+    int origem = tabuleiro->altura - 1 - __builtin_popcount(linhasLimpas);
+    for (int r = tabuleiro->altura - 1; r >= 0; r--) {
+        if (linhasLimpas & (1u << r)) {
+            tabuleiro->linhas[r] = tabuleiro->linhaCheia;
+        } else {
+            tabuleiro->linhas[r] = tabuleiro->linhas[origem--];
+        }
+    }
+}
+
+// Empurra o tabuleiro "quantidade" linhas para cima e preenche a base com
+// linhas de lixo: completas menos a coluna "buraco" (ataque do modo versus)
+// Retorna 0 se algum bloco sairia pelo topo (o tabuleiro não muda).
+int subirLixo(Tabuleiro *tabuleiro, int quantidade, int buraco) {
+    if (quantidade <= 0) return 1;
+    if (quantidade > tabuleiro->altura) return 0;
+    for (int r = tabuleiro->altura - quantidade; r < tabuleiro->altura; r++) {
+        if (tabuleiro->linhas[r] != 0) return 0;
+    }
+
+    for (int r = tabuleiro->altura - 1; r >= quantidade; r--) {
+        tabuleiro->linhas[r] = tabuleiro->linhas[r - quantidade];
+    }
+    uint32_t lixo = tabuleiro->linhaCheia & ~(1u << buraco);
+    for (int r = 0; r < quantidade; r++) {
+        tabuleiro->linhas[r] = lixo;
+    }
+    return 1;
+}
+
+// Deixa a peça cair na coluna dada, fixa e remove as linhas completas
+// Retorna 1 em caso de sucesso e 0 se a peça não cabe (o tabuleiro não muda).
+int soltarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, Jogada *jogada) {
+    int linha = linhaDeQueda(tabuleiro, forma, coluna);
+    if (linha < 0) return 0;
+
+    fixarPeca(tabuleiro, forma, coluna, linha);
+    jogada->coluna = coluna;
+    jogada->linha = linha;
+    jogada->linhasLimpas = limparLinhas(tabuleiro, linha, forma->altura);
+    return 1;
+}
+
+// Desfaz soltarPeca
+void desfazerJogada(Tabuleiro *tabuleiro, const FormaPeca *forma, const Jogada *jogada) {
+    restaurarLinhas(tabuleiro, jogada->linhasLimpas);
+    retirarPeca(tabuleiro, forma, jogada->coluna, jogada->linha);
+}
+
+// Gira a peça que está na posição (coluna, linha), testando os chutes do SRS
+// em ordem até achar um lugar livre. Em caso de sucesso atualiza a posição e
+// retorna a nova rotação; retorna -1 (sem mudar nada) se nenhum teste couber.
+int girarPeca(const Tabuleiro *tabuleiro, TipoPeca tipo, int rotacao, SentidoGiro sentido,
+              int *coluna, int *linha) {
+    const FormaPeca *atual = formaPeca(tipo, rotacao);
+    int novaRotacao = rotacaoGirada(rotacao, sentido);
+    const FormaPeca *nova = formaPeca(tipo, novaRotacao);
+    const Deslocamento *chutes = CHUTES_PECA[tipo][rotacao & (TOTAL_ROTACOES - 1)][sentido];
+
+    // Posição da forma girada com a caixa de rotação parada no lugar
+    int colunaBase = *coluna - atual->colunaCaixa + nova->colunaCaixa;
+    int linhaBase = *linha - atual->linhaCaixa + nova->linhaCaixa;
+
+    for (int i = 0; i < TOTAL_TESTES_CHUTE; i++) {
+        int c = colunaBase + chutes[i].coluna;
+        int l = linhaBase + chutes[i].linha;
+        if (!colide(tabuleiro, nova, c, l)) {
+            *coluna = c;
+            *linha = l;
+            return novaRotacao;
+        }
+    }
+    return -1;
+}
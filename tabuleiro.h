@@ -0,0 +1,45 @@
+#ifndef TABULEIRO_H
+#define TABULEIRO_H
+
+#include <stdint.h>
+
+#include "formas.h"
+
+// Tabuleiro do jogo em bitboard
+// Cada linha é um inteiro de 32 bits em que o bit c representa a coluna c, e a
+// linha 0 é a base. Colisão, fixação e remoção de linhas completas são feitas
+// com operações de bits sobre a linha inteira, nunca célula por célula.
+
+#define LARGURA_PADRAO 10
+#define ALTURA_PADRAO 20
+#define LARGURA_MAXIMA 32
+#define ALTURA_MAXIMA 32      // limita a máscara de linhas removidas a 32 bits
+
+typedef struct {
+    uint32_t linhas[ALTURA_MAXIMA];
+    uint32_t linhaCheia;        // máscara de uma linha completa
+    int largura;
+    int altura;
+} Tabuleiro;
+
+// Onde uma peça foi fixada e quais linhas ela completou
+typedef struct {
+    int coluna;
+    int linha;
+    uint32_t linhasLimpas;      // bit r = linha r removida (índices antes da remoção)
+} Jogada;
+
+void inicializarTabuleiro(Tabuleiro *tabuleiro, int largura, int altura);
+int colide(const Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha);
+int linhaDeQueda(const Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna);
+void fixarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha);
+void retirarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, int linha);
+uint32_t limparLinhas(Tabuleiro *tabuleiro, int linhaInicial, int quantidade);
+void restaurarLinhas(Tabuleiro *tabuleiro, uint32_t linhasLimpas);
+int soltarPeca(Tabuleiro *tabuleiro, const FormaPeca *forma, int coluna, Jogada *jogada);
+void desfazerJogada(Tabuleiro *tabuleiro, const FormaPeca *forma, const Jogada *jogada);
+int subirLixo(Tabuleiro *tabuleiro, int quantidade, int buraco);
+int girarPeca(const Tabuleiro *tabuleiro, TipoPeca tipo, int rotacao, SentidoGiro sentido,
+              int *coluna, int *linha);
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdarg.h>
+#include <string.h>
+
+#include "tela.h"
+
+// Função para inicializar o renderizador
+void inicializarTela(Tela *tela, int ansi) {
+    tela->totalLinhas = 0;
+    tela->totalAnteriores = 0;
+    tela->ansi = ansi;
+    tela->primeiroQuadro = 1;
+    tela->tamanhoSaida = 0;
+    tela->linhasRedesenhadas = 0;
+}
+
+// Força o redesenho completo no próximo quadro (ex.: algo escreveu por cima)
+void invalidarTela(Tela *tela) {
+    tela->primeiroQuadro = 1;
+}
+
+void iniciarQuadro(Tela *tela) {
+    tela->totalLinhas = 0;
+    tela->linhaEscrita = 0;
+    tela->colunaEscrita = 0;
+}
+
+// Faz as próximas linhas começarem na linha e coluna dadas, ao lado do que já
+// foi escrito nelas (permite montar painéis lado a lado)
+void posicionarEscrita(Tela *tela, int linha, int coluna) {
+    tela->linhaEscrita = linha;
+    tela->colunaEscrita = coluna < TELA_MAX_COLUNAS - 1 ? coluna : TELA_MAX_COLUNAS - 1;
+}
+
+// Escreve uma linha formatada no quadro em montagem e passa para a seguinte
+void escreverLinha(Tela *tela, const char *formato, ...) {
+    if (tela->linhaEscrita >= TELA_MAX_LINHAS) return;
+
+    // Linhas ainda não usadas neste quadro começam vazias
+    while (tela->totalLinhas <= tela->linhaEscrita) {
+        tela->linhas[tela->totalLinhas++][0] = '\0';
+    }
+
+    // Completa com espaços até a coluna de escrita
+    char *linha = tela->linhas[tela->linhaEscrita];
+    size_t tamanho = strlen(linha);
+    while (tamanho < (size_t) tela->colunaEscrita) {
+        linha[tamanho++] = ' ';
+    }
+    linha[tamanho] = '\0';
+
+    va_list argumentos;
+    va_start(argumentos, formato);
+    vsnprintf(linha + tamanho, TELA_MAX_COLUNAS - tamanho, formato, argumentos);
+    va_end(argumentos);
+
+    tela->linhaEscrita++;
+}
+
+// Copia bytes para o buffer de saída
+static void acrescentar(Tela *tela, const char *texto, size_t tamanho) {
+    if (tela->tamanhoSaida + tamanho > TELA_TAMANHO_SAIDA) return;
+
+    memcpy(tela->saida + tela->tamanhoSaida, texto, tamanho);
+    tela->tamanhoSaida += tamanho;
+}
+
+static void acrescentarTexto(Tela *tela, const char *texto) {
+    acrescentar(tela, texto, strlen(texto));
+}
+
+// Posiciona o cursor no início da linha (contada a partir de 0)
+static void moverCursor(Tela *tela, int linha) {
+    char sequencia[16];
+    int tamanho = snprintf(sequencia, sizeof(sequencia), "\x1b[%d;1H", linha + 1);
+    acrescentar(tela, sequencia, tamanho);
+}
+
+// Compara o quadro montado com o anterior e envia só as diferenças
+void finalizarQuadro(Tela *tela, FILE *destino) {
+    tela->tamanhoSaida = 0;
+
+    if (!tela->ansi) {
+        for (int i = 0; i < tela->totalLinhas; i++) {
+            acrescentarTexto(tela, tela->linhas[i]);
+            acrescentar(tela, "\n", 1);
+        }
+        tela->linhasRedesenhadas += tela->totalLinhas;
+    } else {
+        if (tela->primeiroQuadro) {
+            acrescentarTexto(tela, "\x1b[H\x1b[2J");
+        }
+
+        for (int i = 0; i < tela->totalLinhas; i++) {
+            if (!tela->primeiroQuadro && i < tela->totalAnteriores &&
+                strcmp(tela->linhas[i], tela->anteriores[i]) == 0) {
+                continue;
+            }
+
+            moverCursor(tela, i);
+            acrescentarTexto(tela, tela->linhas[i]);
+            acrescentarTexto(tela, "\x1b[K");
+            memcpy(tela->anteriores[i], tela->linhas[i], TELA_MAX_COLUNAS);
+            tela->linhasRedesenhadas++;
+        }
+
+        // Apaga as linhas que sobraram do quadro anterior e deixa o cursor
+        // logo abaixo do quadro, com o resto da tela limpo
+        moverCursor(tela, tela->totalLinhas);
+        acrescentarTexto(tela, "\x1b[J");
+        tela->totalAnteriores = tela->totalLinhas;
+        tela->primeiroQuadro = 0;
+    }
+
+    fwrite(tela->saida, 1, tela->tamanhoSaida, destino);
+}
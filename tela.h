@@ -0,0 +1,38 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include <stdio.h>
+
+// Renderizador de tela
+// O quadro é montado linha a linha em memória. Ao finalizar, ele é comparado
+// com o quadro anterior e só as linhas que mudaram são reescritas, usando
+// sequências ANSI para posicionar o cursor. Tudo vai para um único buffer,
+// enviado de uma vez por quadro. Se a saída não for um terminal, o quadro
+// inteiro é escrito sem sequências ANSI (mas ainda de uma vez só).
+
+#define TELA_MAX_LINHAS 64
+#define TELA_MAX_COLUNAS 256
+#define TELA_TAMANHO_SAIDA (TELA_MAX_LINHAS * (TELA_MAX_COLUNAS + 16) + 64)
+
+typedef struct {
+    char linhas[TELA_MAX_LINHAS][TELA_MAX_COLUNAS];      // quadro em montagem
+    char anteriores[TELA_MAX_LINHAS][TELA_MAX_COLUNAS];  // último quadro enviado
+    int totalLinhas;
+    int totalAnteriores;
+    int linhaEscrita;       // linha onde o próximo escreverLinha vai escrever
+    int colunaEscrita;      // coluna (em bytes) onde o texto começa nessa linha
+    int ansi;               // usa sequências ANSI e desenho incremental
+    int primeiroQuadro;     // o próximo quadro limpa a tela inteira
+    char saida[TELA_TAMANHO_SAIDA];
+    size_t tamanhoSaida;
+    unsigned long linhasRedesenhadas;   // estatística: linhas realmente enviadas
+} Tela;
+
+void inicializarTela(Tela *tela, int ansi);
+void iniciarQuadro(Tela *tela);
+void escreverLinha(Tela *tela, const char *formato, ...);
+void posicionarEscrita(Tela *tela, int linha, int coluna);
+void finalizarQuadro(Tela *tela, FILE *destino);
+void invalidarTela(Tela *tela);
+
+#endif
@@ -0,0 +1,137 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "gerador.h"
+#include "transposicao.h"
+
+// Semente fixa: as chaves são sempre as mesmas, o que deixa a busca reproduzível
+#define SEMENTE_ZOBRIST 0x5A0B815712345ULL
+
+static void gerarChaves(ChavesZobrist *chaves) {
+    GeradorPecas gerador;
+    inicializarGerador(&gerador, SEMENTE_ZOBRIST, GERADOR_UNIFORME);
+
+    uint64_t *valores = (uint64_t *) chaves;
+    for (size_t i = 0; i < sizeof(*chaves) / sizeof(uint64_t); i++) {
+        valores[i] = proximoAleatorio(&gerador);
+    }
+
+    // Posição vazia da fila ou da pilha não contribui para a chave
+    for (int i = 0; i < TAMANHO_FILA; i++) chaves->fila[i][PECA_NENHUMA] = 0;
+    for (int i = 0; i < TAMANHO_PILHA; i++) chaves->pilha[i][PECA_NENHUMA] = 0;
+}
+
+// Função para criar a tabela com até "megabytes" de memória (arredondado para
+// baixo até uma potência de dois de baldes)
+// Retorna 1 em caso de sucesso e 0 se não houver memória.
+int criarTabelaTransposicao(TabelaTransposicao *tabela, size_t megabytes) {
+    size_t baldes = 1;
+    while (baldes * 2 * sizeof(BaldeTransposicao) <= megabytes * 1024 * 1024) baldes *= 2;
+
+    gerarChaves(&tabela->chaves);
+    tabela->baldes = aligned_alloc(64, baldes * sizeof(BaldeTransposicao));
+    tabela->mascara = tabela->baldes != NULL ? baldes - 1 : 0;
+    tabela->geracao = 0;
+    if (tabela->baldes == NULL) return 0;
+
+    memset(tabela->baldes, 0, baldes * sizeof(BaldeTransposicao));
+    return 1;
+}
+
+void liberarTabelaTransposicao(TabelaTransposicao *tabela) {
+    free(tabela->baldes);
+    tabela->baldes = NULL;
+    tabela->mascara = 0;
+}
+
+void novaGeracaoTransposicao(TabelaTransposicao *tabela) {
+    tabela->geracao = (tabela->geracao + 1) & 0xFF;
+}
+
+// Campos de "dados": bits 0-31 valor (float), 32-39 profundidade, 40-47 geração
+static uint64_t empacotarDados(float valor, int profundidade, unsigned geracao) {
+    uint32_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    return bits | (uint64_t) (profundidade & 0xFF) << 32 | (uint64_t) (geracao & 0xFF) << 40;
+}
+
+static float valorDados(uint64_t dados) {
+    uint32_t bits = (uint32_t) dados;
+    float valor;
+    memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+// Procura a chave no seu balde; retorna 1 e preenche "valor" se achar
+int consultarTransposicao(const TabelaTransposicao *tabela, uint64_t chave, float *valor) {
+    BaldeTransposicao *balde = &tabela->baldes[chave & tabela->mascara];
+
+    for (int i = 0; i < ENTRADAS_POR_BALDE; i++) {
+        uint64_t dados = atomic_load_explicit(&balde->entradas[i].dados, memory_order_relaxed);
+        uint64_t verificacao = atomic_load_explicit(&balde->entradas[i].verificacao, memory_order_relaxed);
+        if ((verificacao ^ dados) == chave && dados != 0) {
+            *valor = valorDados(dados);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Grava o valor de um estado. Dentro do balde, reaproveita a entrada da mesma
+// chave; senão substitui primeiro entradas de jogadas anteriores e, entre elas,
+// a de menor profundidade (a mais barata de recalcular).
+// Retorna 1 se outra chave ainda válida foi descartada.
+int gravarTransposicao(TabelaTransposicao *tabela, uint64_t chave, float valor, int profundidade) {
+    BaldeTransposicao *balde = &tabela->baldes[chave & tabela->mascara];
+    unsigned geracao = tabela->geracao;
+    int vitima = 0;
+    int menorPrioridade = 1 << 30;
+
+    for (int i = 0; i < ENTRADAS_POR_BALDE; i++) {
+        uint64_t dados = atomic_load_explicit(&balde->entradas[i].dados, memory_order_relaxed);
+        uint64_t verificacao = atomic_load_explicit(&balde->entradas[i].verificacao, memory_order_relaxed);
+        if ((verificacao ^ dados) == chave) {
+            vitima = i;
+            menorPrioridade = -1;
+            break;
+        }
+
+        int prioridade = dados == 0 ? -1 : (int) ((dados >> 32) & 0xFF);
+        if (dados != 0 && ((dados >> 40) & 0xFF) == geracao) prioridade += 256;
+        if (prioridade < menorPrioridade) {
+            menorPrioridade = prioridade;
+            vitima = i;
+        }
+    }
+
+    uint64_t dados = empacotarDados(valor, profundidade, geracao);
+    atomic_store_explicit(&balde->entradas[vitima].verificacao, chave ^ dados, memory_order_relaxed);
+    atomic_store_explicit(&balde->entradas[vitima].dados, dados, memory_order_relaxed);
+    return menorPrioridade >= 0;
+}
+
+// Chave de Zobrist do tabuleiro inteiro (usada na raiz e depois de remover linhas)
+uint64_t chaveTabuleiro(const ChavesZobrist *chaves, const Tabuleiro *tabuleiro) {
+    uint64_t chave = 0;
+    for (int r = 0; r < tabuleiro->altura; r++) {
+        uint32_t linha = tabuleiro->linhas[r];
+        while (linha) {
+            chave ^= chaves->celulas[r][__builtin_ctz(linha)];
+            linha &= linha - 1;
+        }
+    }
+    return chave;
+}
+
+// Contribuição das células de uma peça fixada em (coluna, linha)
+uint64_t chaveForma(const ChavesZobrist *chaves, const FormaPeca *forma, int coluna, int linha) {
+    uint64_t chave = 0;
+    for (int r = 0; r < forma->altura; r++) {
+        uint32_t bits = forma->linhas[r];
+        while (bits) {
+            chave ^= chaves->celulas[linha + r][coluna + __builtin_ctz(bits)];
+            bits &= bits - 1;
+        }
+    }
+    return chave;
+}
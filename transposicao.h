@@ -0,0 +1,60 @@
+#ifndef TRANSPOSICAO_H
+#define TRANSPOSICAO_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "motor.h"
+
+// Tabela de transposição da busca do bot
+// Guarda o valor já calculado de um estado (tabuleiro + fila + pilha +
+// profundidade restante) para que a busca não o recalcule quando chega a ele
+// por outro caminho (reservar e depois jogar, trocar, jogar em outra ordem...).
+//
+// A chave é um hash de Zobrist: um número aleatório para cada célula do
+// tabuleiro e para cada tipo em cada posição da fila e da pilha, combinados
+// com XOR. Fixar uma peça muda só as suas quatro células, então a chave do
+// tabuleiro é atualizada com quatro XORs.
+//
+// A tabela tem tamanho fixo e é compartilhada pelas threads sem travas: cada
+// entrada guarda (chave XOR dados, dados), e uma leitura só é aceita se os
+// dois campos baterem com a chave. Uma escrita concorrente que deixe os
+// campos misturados apenas faz a leitura falhar.
+
+#define ENTRADAS_POR_BALDE 4    // 4 entradas de 16 bytes = uma linha de cache
+
+// Números aleatórios do hash de Zobrist
+typedef struct {
+    uint64_t celulas[ALTURA_MAXIMA][LARGURA_MAXIMA];
+    uint64_t fila[TAMANHO_FILA][TOTAL_TIPOS_PECA + 1];
+    uint64_t pilha[TAMANHO_PILHA][TOTAL_TIPOS_PECA + 1];
+    uint64_t profundidade[64];
+} ChavesZobrist;
+
+typedef struct {
+    _Atomic uint64_t verificacao;   // chave XOR dados
+    _Atomic uint64_t dados;         // valor (float), profundidade e geração
+} EntradaTransposicao;
+
+typedef struct {
+    _Alignas(64) EntradaTransposicao entradas[ENTRADAS_POR_BALDE];
+} BaldeTransposicao;
+
+typedef struct {
+    ChavesZobrist chaves;
+    BaldeTransposicao *baldes;
+    size_t mascara;                 // quantidade de baldes - 1 (potência de dois)
+    unsigned geracao;               // muda a cada jogada; entradas antigas são substituídas primeiro
+} TabelaTransposicao;
+
+int criarTabelaTransposicao(TabelaTransposicao *tabela, size_t megabytes);
+void liberarTabelaTransposicao(TabelaTransposicao *tabela);
+void novaGeracaoTransposicao(TabelaTransposicao *tabela);
+int consultarTransposicao(const TabelaTransposicao *tabela, uint64_t chave, float *valor);
+int gravarTransposicao(TabelaTransposicao *tabela, uint64_t chave, float valor, int profundidade);
+
+uint64_t chaveTabuleiro(const ChavesZobrist *chaves, const Tabuleiro *tabuleiro);
+uint64_t chaveForma(const ChavesZobrist *chaves, const FormaPeca *forma, int coluna, int linha);
+
+#endif
@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "versoes.h"
+
+// Garante espaço para mais um item no vetor, dobrando a capacidade
+// Retorna 1 em caso de sucesso e 0 se não houver memória.
+static int garantirEspaco(void **vetor, size_t *capacidade, size_t quantidade, size_t tamanhoItem) {
+    if (quantidade < *capacidade) return 1;
+
+    size_t nova = *capacidade > 0 ? *capacidade * 2 : 64;
+    void *maior = realloc(*vetor, nova * tamanhoItem);
+    if (maior == NULL) return 0;
+
+    *vetor = maior;
+    *capacidade = nova;
+    return 1;
+}
+
+// Guarda as peças do estado, reaproveitando o registro "anterior" se nada
+// mudou. A comparação é byte a byte (as cópias também), então bytes de
+// preenchimento diferentes no máximo impedem o compartilhamento.
+// Retorna o índice do registro, ou VERSAO_NENHUMA se não houver memória.
+static uint32_t guardarPecas(ArvoreVersoes *arvore, uint32_t anterior) {
+    const EstadoJogo *estado = arvore->estado;
+
+    if (anterior != VERSAO_NENHUMA) {
+        const PecasVersao *pecas = &arvore->pecas[anterior];
+        if (memcmp(&pecas->fila, &estado->fila, sizeof(FilaCircular)) == 0 &&
+            memcmp(&pecas->pilha, &estado->pilha, sizeof(PilhaReserva)) == 0 &&
+            memcmp(&pecas->gerador, &estado->gerador, sizeof(GeradorPecas)) == 0) {
+            return anterior;
+        }
+    }
+
+    if (!garantirEspaco((void **) &arvore->pecas, &arvore->capacidadePecas, arvore->quantidadePecas,
+                        sizeof(PecasVersao))) {
+        return VERSAO_NENHUMA;
+    }
+    PecasVersao *novas = &arvore->pecas[arvore->quantidadePecas];
+    memcpy(&novas->fila, &estado->fila, sizeof(FilaCircular));
+    memcpy(&novas->pilha, &estado->pilha, sizeof(PilhaReserva));
+    memcpy(&novas->gerador, &estado->gerador, sizeof(GeradorPecas));
+    return (uint32_t) arvore->quantidadePecas++;
+}
+
+// Guarda o tabuleiro do estado em blocos, reaproveitando os blocos de
+// "anteriores" (ou o bloco vazio) que não mudaram
+// Retorna 1 em caso de sucesso e 0 se não houver memória.
+static int guardarBlocos(ArvoreVersoes *arvore, const uint32_t *anteriores, uint32_t *blocos) {
+    const Tabuleiro *tabuleiro = &arvore->estado->tabuleiro;
+
+    for (int b = 0; b < BLOCOS_TABULEIRO; b++) {
+        const uint32_t *linhas = &tabuleiro->linhas[b * LINHAS_POR_BLOCO];
+
+        if (anteriores != NULL && memcmp(arvore->blocos[anteriores[b]].linhas, linhas, sizeof(BlocoLinhas)) == 0) {
+            blocos[b] = anteriores[b];
+            continue;
+        }
+        if (memcmp(arvore->blocos[0].linhas, linhas, sizeof(BlocoLinhas)) == 0) {
+            blocos[b] = 0;
+            continue;
+        }
+
+        if (!garantirEspaco((void **) &arvore->blocos, &arvore->capacidadeBlocos, arvore->quantidadeBlocos,
+                            sizeof(BlocoLinhas))) {
+            return 0;
+        }
+        memcpy(arvore->blocos[arvore->quantidadeBlocos].linhas, linhas, sizeof(BlocoLinhas));
+        blocos[b] = (uint32_t) arvore->quantidadeBlocos++;
+    }
+    return 1;
+}
+
+// Cria uma versão com o estado atual da partida, filha de "pai"
+// Retorna o índice da versão, ou VERSAO_NENHUMA se não houver memória.
+static uint32_t novaVersao(ArvoreVersoes *arvore, uint32_t pai, AcaoJogo acao) {
+    EstadoJogo *estado = arvore->estado;
+    uint32_t blocos[BLOCOS_TABULEIRO];
+
+    if (!garantirEspaco((void **) &arvore->versoes, &arvore->capacidadeVersoes, arvore->quantidadeVersoes,
+                        sizeof(VersaoJogo))) {
+        return VERSAO_NENHUMA;
+    }
+    uint32_t pecas = guardarPecas(arvore, pai != VERSAO_NENHUMA ? arvore->versoes[pai].pecas : VERSAO_NENHUMA);
+    if (pecas == VERSAO_NENHUMA) return VERSAO_NENHUMA;
+    if (!guardarBlocos(arvore, pai != VERSAO_NENHUMA ? arvore->versoes[pai].blocos : NULL, blocos)) {
+        return VERSAO_NENHUMA;
+    }
+
+    uint32_t indice = (uint32_t) arvore->quantidadeVersoes++;
+    VersaoJogo *versao = &arvore->versoes[indice];
+    versao->pai = pai;
+    versao->primeiroFilho = VERSAO_NENHUMA;
+    versao->proximoIrmao = VERSAO_NENHUMA;
+    versao->filhoRefazer = VERSAO_NENHUMA;
+    versao->pecas = pecas;
+    memcpy(versao->blocos, blocos, sizeof(blocos));
+    versao->profundidade = 0;
+    versao->linhasRemovidas = estado->linhasRemovidas;
+    versao->colunaMira = (signed char) estado->colunaMira;
+    versao->rotacaoMira = (unsigned char) estado->rotacaoMira;
+    versao->acao = (unsigned char) acao;
+
+    // O desfazer do motor tira um registro do histórico; as demais ações põem um
+    RegistroHistorico *registro = registroHistorico(&estado->historico, 0);
+    versao->temRegistro = acao != ACAO_DESFAZER && registro != NULL;
+    if (versao->temRegistro) versao->registro = *registro;
+
+    // Os filhos ficam do mais novo para o mais antigo
+    if (pai != VERSAO_NENHUMA) {
+        VersaoJogo *versaoPai = &arvore->versoes[pai];
+        versao->profundidade = versaoPai->profundidade + 1;
+        versao->proximoIrmao = versaoPai->primeiroFilho;
+        versaoPai->primeiroFilho = indice;
+        versaoPai->filhoRefazer = indice;
+    }
+    return indice;
+}
+
+// Função para começar a árvore com o estado atual da partida como raiz
+// Retorna 1 em caso de sucesso e 0 se não houver memória.
+int criarArvoreVersoes(ArvoreVersoes *arvore, EstadoJogo *estado) {
+    memset(arvore, 0, sizeof(*arvore));
+    arvore->estado = estado;
+
+    // Bloco 0: linhas vazias, compartilhado por toda a parte alta do tabuleiro
+    if (!garantirEspaco((void **) &arvore->blocos, &arvore->capacidadeBlocos, 0, sizeof(BlocoLinhas))) return 0;
+    memset(&arvore->blocos[0], 0, sizeof(BlocoLinhas));
+    arvore->quantidadeBlocos = 1;
+
+    arvore->atual = novaVersao(arvore, VERSAO_NENHUMA, ACAO_SAIR);
+    if (arvore->atual == VERSAO_NENHUMA) {
+        liberarArvoreVersoes(arvore);
+        return 0;
+    }
+    return 1;
+}
+
+void liberarArvoreVersoes(ArvoreVersoes *arvore) {
+    free(arvore->versoes);
+    free(arvore->pecas);
+    free(arvore->blocos);
+    arvore->versoes = NULL;
+    arvore->pecas = NULL;
+    arvore->blocos = NULL;
+    arvore->quantidadeVersoes = arvore->quantidadePecas = arvore->quantidadeBlocos = 0;
+    arvore->capacidadeVersoes = arvore->capacidadePecas = arvore->capacidadeBlocos = 0;
+}
+
+// Função para registrar a ação que acabou de ser aplicada na partida
+// Retorna 0 se não houver memória (a ação fica fora da árvore).
+int registrarVersao(ArvoreVersoes *arvore, AcaoJogo acao) {
+    if (acao == ACAO_SAIR || acao == ACAO_VISUALIZAR_HISTORICO) return 1;
+
+    // A mesma ação a partir da mesma versão dá o mesmo estado: segue o ramo
+    // que já existe. O desfazer do motor é a exceção, porque depende do
+    // histórico do motor e não só da versão.
+    VersaoJogo *atual = &arvore->versoes[arvore->atual];
+    if (acao != ACAO_DESFAZER) {
+        for (uint32_t filho = atual->primeiroFilho; filho != VERSAO_NENHUMA; filho = arvore->versoes[filho].proximoIrmao) {
+            if (arvore->versoes[filho].acao == acao) {
+                atual->filhoRefazer = filho;
+                arvore->atual = filho;
+                return 1;
+            }
+        }
+    }
+
+    uint32_t indice = novaVersao(arvore, arvore->atual, acao);
+    if (indice == VERSAO_NENHUMA) return 0;
+    arvore->atual = indice;
+    return 1;
+}
+
+// Observador do motor (ver EstadoJogo.observador) que registra cada ação
+void registrarAoExecutar(void *contexto, AcaoJogo acao) {
+    registrarVersao(contexto, acao);
+}
+
+// Refaz o histórico do motor com os registros mais recentes do caminho até
+// a versão, para que a visualização (e o desfazer do motor) continuem valendo.
+// Cada desfazer do motor no caminho cancela o registro anterior mais próximo.
+static void reconstruirHistorico(ArvoreVersoes *arvore, uint32_t versao) {
+    HistoricoJogo *historico = &arvore->estado->historico;
+    size_t quantidade = 0;
+    size_t cancelados = 0;
+
+    for (uint32_t v = versao; v != VERSAO_NENHUMA && quantidade < historico->capacidade; v = arvore->versoes[v].pai) {
+        const VersaoJogo *atual = &arvore->versoes[v];
+        if (atual->acao == ACAO_DESFAZER) {
+            cancelados++;
+        } else if (atual->temRegistro) {
+            if (cancelados > 0) {
+                cancelados--;
+            } else {
+                quantidade++;
+            }
+        }
+    }
+
+    limparHistorico(historico);
+    historico->quantidade = quantidade;
+    cancelados = 0;
+    for (uint32_t v = versao; quantidade > 0; v = arvore->versoes[v].pai) {
+        const VersaoJogo *atual = &arvore->versoes[v];
+        if (atual->acao == ACAO_DESFAZER) {
+            cancelados++;
+        } else if (atual->temRegistro) {
+            if (cancelados > 0) {
+                cancelados--;
+            } else {
+                historico->registros[--quantidade] = atual->registro;
+            }
+        }
+    }
+}
+
+// Função para levar a partida ao estado de uma versão
+// Com o gerador numa thread à parte (EstadoJogo.produtor) o gerador não volta.
+void restaurarVersao(ArvoreVersoes *arvore, uint32_t versao) {
+    EstadoJogo *estado = arvore->estado;
+    const VersaoJogo *destino = &arvore->versoes[versao];
+    const PecasVersao *pecas = &arvore->pecas[destino->pecas];
+
+    memcpy(&estado->fila, &pecas->fila, sizeof(FilaCircular));
+    memcpy(&estado->pilha, &pecas->pilha, sizeof(PilhaReserva));
+    if (estado->produtor == NULL) memcpy(&estado->gerador, &pecas->gerador, sizeof(GeradorPecas));
+    for (int b = 0; b < BLOCOS_TABULEIRO; b++) {
+        memcpy(&estado->tabuleiro.linhas[b * LINHAS_POR_BLOCO], arvore->blocos[destino->blocos[b]].linhas,
+               sizeof(BlocoLinhas));
+    }
+    estado->colunaMira = destino->colunaMira;
+    estado->rotacaoMira = destino->rotacaoMira;
+    estado->linhasRemovidas = destino->linhasRemovidas;
+    estado->pecaAfetada = PECA_VAZIA;
+    estado->pecaNova = PECA_VAZIA;
+
+    reconstruirHistorico(arvore, versao);
+    arvore->atual = versao;
+}
+
+// Funções de navegação
+// Retornam 1 se mudaram de versão e 0 se não havia para onde ir.
+int desfazerVersao(ArvoreVersoes *arvore) {
+    uint32_t pai = arvore->versoes[arvore->atual].pai;
+    if (pai == VERSAO_NENHUMA) return 0;
+
+    restaurarVersao(arvore, pai);
+    return 1;
+}
+
+int refazerVersao(ArvoreVersoes *arvore) {
+    const VersaoJogo *atual = &arvore->versoes[arvore->atual];
+    uint32_t filho = atual->filhoRefazer != VERSAO_NENHUMA ? atual->filhoRefazer : atual->primeiroFilho;
+    if (filho == VERSAO_NENHUMA) return 0;
+
+    restaurarVersao(arvore, filho);
+    return 1;
+}
+
+// Passa para o próximo ramo irmão da versão atual (em rodízio)
+int trocarRamoVersao(ArvoreVersoes *arvore) {
+    const VersaoJogo *atual = &arvore->versoes[arvore->atual];
+    if (atual->pai == VERSAO_NENHUMA) return 0;
+
+    VersaoJogo *pai = &arvore->versoes[atual->pai];
+    uint32_t proximo = atual->proximoIrmao != VERSAO_NENHUMA ? atual->proximoIrmao : pai->primeiroFilho;
+    if (proximo == arvore->atual) return 0;
+
+    pai->filhoRefazer = proximo;
+    restaurarVersao(arvore, proximo);
+    return 1;
+}
+
+// Função para contar os ramos que saem do pai da versão
+// Retorna o total e guarda em "posicao" a ordem da versão entre eles (1 = o mais antigo).
+int contarRamosVersao(const ArvoreVersoes *arvore, uint32_t versao, int *posicao) {
+    uint32_t pai = arvore->versoes[versao].pai;
+    *posicao = 1;
+    if (pai == VERSAO_NENHUMA) return 1;
+
+    int total = 0;
+    int antesDela = 0;      // ramos mais novos que a versão
+    for (uint32_t v = arvore->versoes[pai].primeiroFilho; v != VERSAO_NENHUMA; v = arvore->versoes[v].proximoIrmao) {
+        if (v == versao) antesDela = total;
+        total++;
+    }
+    *posicao = total - antesDela;
+    return total;
+}
@@ -0,0 +1,79 @@
+#ifndef VERSOES_H
+#define VERSOES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "motor.h"
+
+// Árvore de versões da partida (desfazer e refazer sem limite, com ramos)
+// Cada ação aplicada vira uma versão nova, filha da versão atual. Desfazer
+// volta ao pai e refazer desce ao último filho visitado; jogar outra coisa
+// depois de desfazer cria um ramo novo sem perder o antigo. Como o motor é
+// determinístico (o gerador de peças faz parte da versão), repetir a mesma
+// ação a partir de uma versão leva à versão filha que já existe.
+//
+// As versões compartilham a estrutura que não mudou: o tabuleiro é guardado
+// em blocos de LINHAS_POR_BLOCO linhas e cada versão só aponta para eles, de
+// modo que uma peça fixada cria no máximo dois blocos novos e um movimento da
+// mira não cria nenhum; fila, pilha e gerador ficam num registro à parte,
+// também compartilhado enquanto não mudam. Todos os vetores usam índices, e
+// não ponteiros, para poderem crescer com realloc.
+
+#define LINHAS_POR_BLOCO 8
+#define BLOCOS_TABULEIRO (ALTURA_MAXIMA / LINHAS_POR_BLOCO)
+#define VERSAO_NENHUMA UINT32_MAX
+
+typedef struct {
+    uint32_t linhas[LINHAS_POR_BLOCO];
+} BlocoLinhas;
+
+// Peças da versão: fila, pilha e o gerador que repõe a fila
+typedef struct {
+    FilaCircular fila;
+    PilhaReserva pilha;
+    GeradorPecas gerador;
+} PecasVersao;
+
+typedef struct {
+    uint32_t pai;
+    uint32_t primeiroFilho;
+    uint32_t proximoIrmao;
+    uint32_t filhoRefazer;          // ramo seguido por refazerVersao (o último visitado)
+    uint32_t pecas;                 // índice em ArvoreVersoes.pecas
+    uint32_t blocos[BLOCOS_TABULEIRO];
+    uint32_t profundidade;          // ações desde a raiz
+    long linhasRemovidas;
+    signed char colunaMira;
+    unsigned char rotacaoMira;
+    unsigned char acao;             // ação que levou do pai a esta versão
+    unsigned char temRegistro;      // a ação deixou "registro" no histórico do motor
+    RegistroHistorico registro;
+} VersaoJogo;
+
+typedef struct {
+    VersaoJogo *versoes;
+    size_t quantidadeVersoes;
+    size_t capacidadeVersoes;
+    PecasVersao *pecas;
+    size_t quantidadePecas;
+    size_t capacidadePecas;
+    BlocoLinhas *blocos;            // o bloco 0 é sempre vazio
+    size_t quantidadeBlocos;
+    size_t capacidadeBlocos;
+    uint32_t atual;
+    EstadoJogo *estado;             // partida acompanhada (ver registrarAoExecutar)
+} ArvoreVersoes;
+
+int criarArvoreVersoes(ArvoreVersoes *arvore, EstadoJogo *estado);
+void liberarArvoreVersoes(ArvoreVersoes *arvore);
+int registrarVersao(ArvoreVersoes *arvore, AcaoJogo acao);
+void registrarAoExecutar(void *contexto, AcaoJogo acao);
+void restaurarVersao(ArvoreVersoes *arvore, uint32_t versao);
+
+int desfazerVersao(ArvoreVersoes *arvore);
+int refazerVersao(ArvoreVersoes *arvore);
+int trocarRamoVersao(ArvoreVersoes *arvore);
+int contarRamosVersao(const ArvoreVersoes *arvore, uint32_t versao, int *posicao);
+
+#endif
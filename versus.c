@@ -0,0 +1,156 @@
+#include <string.h>
+
+#include "versus.h"
+
+// Semente do gerador dos buracos, derivada da semente da partida
+#define SEMENTE_BURACOS UINT64_C(0x9E3779B97F4A7C15)
+
+// Função para começar uma partida versus com "jogadores" jogadores, todos com
+// a mesma configuração (e, portanto, a mesma sequência de peças)
+// Retorna 1 em caso de sucesso e 0 se faltar memória ou o número de jogadores for inválido.
+int iniciarVersus(PartidaVersus *partida, int jogadores, const ConfiguracaoJogo *configuracao) {
+    if (jogadores < 1 || jogadores > MAX_JOGADORES_VERSUS) return 0;
+
+    memset(partida, 0, sizeof(*partida));
+    for (int j = 0; j < jogadores; j++) {
+        if (!inicializarJogo(&partida->jogadores[j], configuracao)) {
+            partida->quantidade = j;
+            liberarVersus(partida);
+            return 0;
+        }
+        partida->vivo[j] = 1;
+    }
+    partida->quantidade = jogadores;
+    partida->vivos = jogadores;
+    inicializarGerador(&partida->buracos, configuracao->semente ^ SEMENTE_BURACOS, GERADOR_UNIFORME);
+    return 1;
+}
+
+void liberarVersus(PartidaVersus *partida) {
+    for (int j = 0; j < partida->quantidade; j++) {
+        liberarJogo(&partida->jogadores[j]);
+    }
+    partida->quantidade = 0;
+    partida->vivos = 0;
+}
+
+// Linhas de lixo enviadas por uma peça que removeu "linhas" linhas
+int ataqueVersus(int linhas) {
+    static const int ATAQUE[] = {0, 0, 1, 2, 4};
+    return linhas < 0 ? 0 : linhas > 4 ? 4 : ATAQUE[linhas];
+}
+
+static void eliminar(PartidaVersus *partida, int jogador) {
+    partida->vivo[jogador] = 0;
+    partida->lixoPendente[jogador] = 0;
+    partida->vivos--;
+}
+
+// Próximo jogador vivo depois de "jogador" (em rodízio), ou -1 se não houver outro
+static int proximoVivo(const PartidaVersus *partida, int jogador) {
+    for (int passo = 1; passo < partida->quantidade; passo++) {
+        int alvo = (jogador + passo) % partida->quantidade;
+        if (partida->vivo[alvo]) return alvo;
+    }
+    return -1;
+}
+
+// Função para avançar um turno com a ação de cada jogador (acoes[j], um byte
+// por jogador; ACAO_NENHUMA_VERSUS para nenhuma)
+// Retorna quantos jogadores continuam vivos.
+int avancarVersus(PartidaVersus *partida, const unsigned char *acoes) {
+    int ataque[MAX_JOGADORES_VERSUS] = {0};
+    int fixouSemLinhas[MAX_JOGADORES_VERSUS] = {0};
+
+    // Ações, na ordem dos jogadores
+    for (int j = 0; j < partida->quantidade; j++) {
+        AcaoJogo acao = (AcaoJogo) acoes[j];
+        if (!partida->vivo[j] || acao == ACAO_NENHUMA_VERSUS || acao == ACAO_DESFAZER || acao >= TOTAL_ACOES) {
+            continue;
+        }
+
+        EstadoJogo *estado = &partida->jogadores[j];
+        long linhasAntes = estado->linhasRemovidas;
+        ResultadoAcao resultado = executarAcao(estado, acao);
+        if (resultado == RESULTADO_FIM_DE_JOGO) {
+            eliminar(partida, j);
+        } else if (resultado == RESULTADO_OK && (acao == ACAO_JOGAR || acao == ACAO_USAR_RESERVA)) {
+            int linhas = (int) (estado->linhasRemovidas - linhasAntes);
+            if (linhas == 0) {
+                fixouSemLinhas[j] = 1;
+            } else {
+                ataque[j] = ataqueVersus(linhas);
+            }
+        }
+    }
+
+    // Ataques: primeiro cancelam o lixo do próprio atacante, o resto vai ao próximo vivo
+    for (int j = 0; j < partida->quantidade; j++) {
+        if (ataque[j] == 0) continue;
+
+        int cancelado = ataque[j] < partida->lixoPendente[j] ? ataque[j] : partida->lixoPendente[j];
+        partida->lixoPendente[j] -= cancelado;
+        ataque[j] -= cancelado;
+
+        int alvo = proximoVivo(partida, j);
+        if (ataque[j] > 0 && alvo >= 0) {
+            partida->lixoPendente[alvo] += ataque[j];
+            partida->linhasEnviadas[j] += ataque[j];
+        }
+    }
+
+    // O lixo pendente sobe para quem fixou uma peça sem remover linhas
+    for (int j = 0; j < partida->quantidade; j++) {
+        if (!partida->vivo[j] || !fixouSemLinhas[j] || partida->lixoPendente[j] == 0) continue;
+
+        EstadoJogo *estado = &partida->jogadores[j];
+        int buraco = (int) aleatorioAte(&partida->buracos, (uint32_t) estado->tabuleiro.largura);
+        int quantidade = partida->lixoPendente[j];
+        if (receberLixo(estado, quantidade, buraco)) {
+            partida->linhasRecebidas[j] += quantidade;
+            partida->lixoPendente[j] = 0;
+        } else {
+            eliminar(partida, j);
+        }
+    }
+
+    partida->turno++;
+    return partida->vivos;
+}
+
+// FNV-1a de 64 bits, um valor de 64 bits de cada vez
+static uint64_t misturar(uint64_t hash, uint64_t valor) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (valor >> (8 * i)) & 0xFF;
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+// Função para resumir o estado da partida num número, para que os
+// participantes confiram que continuam sincronizados
+uint64_t resumoVersus(const PartidaVersus *partida) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+
+    hash = misturar(hash, (uint64_t) partida->turno);
+    for (int k = 0; k < 4; k++) hash = misturar(hash, partida->buracos.estado[k]);
+    for (int j = 0; j < partida->quantidade; j++) {
+        const EstadoJogo *estado = &partida->jogadores[j];
+
+        hash = misturar(hash, partida->vivo[j]);
+        hash = misturar(hash, (uint64_t) partida->lixoPendente[j]);
+        hash = misturar(hash, (uint64_t) estado->linhasRemovidas);
+        hash = misturar(hash, (uint64_t) estado->colunaMira << 8 | (uint64_t) estado->rotacaoMira);
+        for (int r = 0; r < estado->tabuleiro.altura; r++) hash = misturar(hash, estado->tabuleiro.linhas[r]);
+        for (int k = 0; k < 4; k++) hash = misturar(hash, estado->gerador.estado[k]);
+        FilaCircular fila = estado->fila;     // posicaoFila não recebe uma fila constante
+        for (int i = 0; i < fila.quantidade; i++) {
+            Peca peca = *posicaoFila(&fila, i);
+            hash = misturar(hash, (uint64_t) peca.tipo << 32 | peca.id);
+        }
+        for (int i = 0; i < estado->pilha.quantidade; i++) {
+            hash = misturar(hash, (uint64_t) estado->pilha.pecas[i].tipo << 32 | estado->pilha.pecas[i].id);
+        }
+    }
+    return hash;
+}
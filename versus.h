@@ -0,0 +1,46 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <stdint.h>
+
+#include "motor.h"
+
+// Modo versus em lockstep determinístico
+// Todos os jogadores começam com a mesma semente, então recebem exatamente a
+// mesma sequência de peças. A partida anda em turnos: em cada turno cada
+// jogador escolhe uma ação (ou nenhuma) e todos os participantes aplicam as
+// mesmas ações, na mesma ordem, às partidas de todos os jogadores. Como o
+// motor é determinístico, basta trocar as ações (um byte por jogador e turno)
+// para que todos cheguem ao mesmo estado, sem nunca enviar o estado.
+//
+// Ataques: uma peça que remove 2, 3 ou 4 linhas manda 1, 2 ou 4 linhas de
+// lixo para o próximo jogador vivo (em rodízio). O ataque primeiro cancela o
+// lixo que o próprio jogador tem a receber; o lixo pendente só sobe quando o
+// jogador fixa uma peça sem remover linhas, com um buraco numa coluna sorteada
+// por um gerador próprio da partida (também determinístico). Desfazer não
+// existe no versus: a ação é tratada como nenhuma.
+
+#define MAX_JOGADORES_VERSUS 8
+
+// Ação de quem não faz nada no turno (e de quem já perdeu)
+#define ACAO_NENHUMA_VERSUS ACAO_SAIR
+
+typedef struct {
+    EstadoJogo jogadores[MAX_JOGADORES_VERSUS];
+    int quantidade;
+    int vivos;
+    unsigned char vivo[MAX_JOGADORES_VERSUS];
+    int lixoPendente[MAX_JOGADORES_VERSUS];     // linhas a receber
+    long linhasEnviadas[MAX_JOGADORES_VERSUS];
+    long linhasRecebidas[MAX_JOGADORES_VERSUS];
+    GeradorPecas buracos;                       // sorteia a coluna do buraco do lixo
+    long turno;
+} PartidaVersus;
+
+int iniciarVersus(PartidaVersus *partida, int jogadores, const ConfiguracaoJogo *configuracao);
+void liberarVersus(PartidaVersus *partida);
+int avancarVersus(PartidaVersus *partida, const unsigned char *acoes);
+int ataqueVersus(int linhas);
+uint64_t resumoVersus(const PartidaVersus *partida);
+
+#endif